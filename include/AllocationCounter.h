@@ -0,0 +1,11 @@
+// Counts calls to the global operator new, used for profiling output
+
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+class AllocationCounter {
+public:
+    static unsigned long long getCount();
+};
+
+#endif
@@ -0,0 +1,56 @@
+// Sweeps seeds over every connected component of the input on its own, and
+// puts the best schedule of each component together
+
+#ifndef COMPONENT_SWEEP_H
+#define COMPONENT_SWEEP_H
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RunOptions.h"
+#include "Scheduler.h"
+#include "SeedSweep.h"
+#include "ThreadPool.h"
+#include "WorkerInputData.h"
+
+using namespace std;
+
+// Components share no shifts, so the schedule of one does not change the
+// priorities, paths or bonuses of another. Each gets its own copy of its
+// workers, and a Scheduler per seed only resets and searches those. Every
+// component keeps the seed with its own best score: the total priority, and
+// with it the average, adds up exactly, while the lowest worker and the range
+// of the whole schedule are only known once the components are put together.
+class ComponentSweep {
+public:
+    ComponentSweep(WorkerInputData &data, const RunOptions &options,
+                   ThreadPool *newPool);
+
+    int getNumComponents() const;
+    unsigned int getSeedsChecked() const;
+
+    void run(const atomic<bool> &keepGoing);
+    void combine(Scheduler &scheduler);
+
+    void printComponents(ostream &output) const;
+    void printProfile(ostream &output) const;
+
+private:
+    WorkerInputData &inputData;
+    RunOptions componentOptions;  // each component's sweep runs on one thread
+    ThreadPool *pool;             // searches inside each seed, or null
+    int numThreads;               // components swept at once
+
+    vector<vector<int>> components;  // worker ids of inputData
+    int idleWorkers;                 // in no component, nothing to schedule
+    vector<unique_ptr<WorkerInputData>> componentData;
+    vector<unique_ptr<SeedSweep>> sweeps;
+    double secondsTaken;
+
+    bool hasWork(const vector<int> &workerIds);
+};
+
+#endif
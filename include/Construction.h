@@ -0,0 +1,22 @@
+// Strategies for the initial allocation of a Scheduler run
+
+#ifndef CONSTRUCTION_H
+#define CONSTRUCTION_H
+
+#include <string>
+
+using namespace std;
+
+enum class Construction {
+    RANDOM,            // shifts in shuffled order
+    MOST_CONSTRAINED,  // fewest available workers per required worker first
+    REGRET,            // shift that loses the most by waiting first
+    SCARCITY           // workers with the least availability choose first
+};
+
+static const int NUM_CONSTRUCTIONS = 4;
+
+string constructionName(Construction construction);
+bool parseConstruction(const string &name, Construction &construction);
+
+#endif
@@ -0,0 +1,47 @@
+// Counter-based random number generator for a single Scheduler run
+
+#ifndef COUNTER_RANDOM_H
+#define COUNTER_RANDOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Every value is a pure function of (key, stream, counter), so a seed produces
+// the same numbers no matter which order, thread, or machine it is run on.
+// Streams keep independent uses (noise, shuffling, ...) from overlapping.
+class CounterRandom {
+public:
+    CounterRandom(uint64_t seed);
+
+    void setSeed(uint64_t seed);
+
+    uint64_t at(uint64_t stream, uint64_t counter) const;
+    double uniformAt(uint64_t stream, uint64_t counter) const;  // [0, 1)
+    uint32_t belowAt(uint64_t stream, uint64_t counter, uint32_t bound) const;
+
+    void fillUniform(double *out, size_t n, uint64_t stream) const;
+
+    // Fisher-Yates shuffle drawing from the given stream. std::shuffle is not
+    // used because its distribution is implementation defined.
+    template <typename T>
+    void shuffle(vector<T> &toShuffle, uint64_t stream) const {
+        for (size_t i = toShuffle.size(); i > 1; i--) {
+            size_t j = belowAt(stream, i, (uint32_t) i);
+            swap(toShuffle[i - 1], toShuffle[j]);
+        }
+    }
+
+    // SplitMix64 finalizer, a bijection that maps 0 to 0
+    static uint64_t mix(uint64_t x);
+
+private:
+
+    uint64_t key;
+};
+
+#endif
@@ -0,0 +1,51 @@
+// Bounded pool of the best distinct schedules found by a sweep
+
+#ifndef ELITE_POOL_H
+#define ELITE_POOL_H
+
+#include <stdint.h>
+
+#include <mutex>
+#include <vector>
+
+#include "Perturbation.h"
+
+using namespace std;
+
+// a finished schedule, kept after its Scheduler moved on to another seed
+struct EliteSchedule {
+    double score = -1.0;
+    unsigned int seed = 0;   // the seed it came from, or the one it started at
+    Perturbation perturbation;  // the seed's
+    uint64_t hash = 0;       // Scheduler's state hash, the same up to swaps
+    vector<int> slotIds;     // every allocated slot, in increasing order
+};
+
+// Keeps the best capacity schedules by score, ties to the lower seed, with at
+// most one per state hash. Which schedules end up in the pool does not depend
+// on the order they are offered in, so it is the same for any number of
+// threads. Safe to offer from several threads at once
+class ElitePool {
+public:
+    ElitePool(int newCapacity);  // 0 keeps nothing
+
+    bool isEnabled() const;
+    int getCapacity() const;
+
+    bool accepts(double score, unsigned int seed) const;
+    bool offer(const EliteSchedule &schedule);  // true if it was added
+
+    vector<EliteSchedule> getSchedules() const;  // best first
+    int size() const;
+
+private:
+    int capacity;
+    mutable mutex lock;
+    vector<EliteSchedule> schedules;  // best first
+
+    static bool better(double score1, unsigned int seed1,
+                       double score2, unsigned int seed2);
+    bool acceptsLocked(double score, unsigned int seed) const;
+};
+
+#endif
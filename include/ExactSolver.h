@@ -0,0 +1,168 @@
+// Branch and bound over every schedule of a small input, for the true best
+// score instead of the best of many seeds
+
+#ifndef EXACT_SOLVER_H
+#define EXACT_SOLVER_H
+
+#include <limits.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "FixedScore.h"
+#include "ScheduleData.h"
+#include "ScoreWeights.h"
+#include "Scheduler.h"
+#include "ThreadPool.h"
+#include "TimeSlotNode.h"
+#include "WorkerInputData.h"
+#include "WorkerNode.h"
+
+using namespace std;
+
+// Fills one shift at a time, the shifts with the fewest spare candidates
+// first, trying every group of workers for each. The score counts the range
+// as positive, so an unbalanced schedule can score higher than any balanced
+// one; the search only takes schedules whose range over every worker is at
+// most the incumbent's, the best of a few heuristic seeds. Within those it
+// finds the best score, or proves the incumbent is.
+//
+// A node is cut when its schedules cannot be that balanced, or when a bound
+// on their score is no better than the incumbent: shifts already filled count
+// exactly, since penalties only grow as shifts are added, and the rest count
+// their best candidates without penalties and with every liked coworker that
+// could share them. Every worker's average is bounded the same way, which
+// bounds the lowest. Interchangeable workers with the same shifts so far are
+// only taken in order. The top of the tree is split into tasks that threads
+// take in turn, sharing the incumbent.
+class ExactSolver {
+public:
+    static const int MAX_WORKERS = 64;        // a bit each
+    static const int WARM_START_SEEDS = 100;  // heuristic seeds to start from
+
+    ExactSolver(WorkerInputData &data, int newThreads);
+
+    void offerIncumbent(const Scheduler &scheduler);
+    void run(const atomic<bool> &keepGoing);
+    void load(Scheduler &scheduler) const;
+
+    bool isOptimal() const;
+    double getBestScore() const;
+    void printStats(ostream &output) const;
+
+private:
+    WorkerInputData &inputData;
+    const ScoreWeights &weights;
+    int numThreads;
+    int numWorkers;
+
+    // a shift that needs workers, in search order. Bits of a worker's
+    // columns are indexes into columns
+    struct Column {
+        int day;
+        int shift;
+        int needed;
+        uint64_t available;      // workers
+        vector<int> candidates;  // best optimistic value first
+        vector<vector<int>> earlierTwins;  // by candidate, interchangeable
+                                           // candidates before them
+    };
+    vector<Column> columns;
+    vector<uint64_t> dayColumns;  // by day
+    int totalShifts;
+
+    // by worker
+    vector<int> maxShifts;
+    vector<uint64_t> likes;
+    vector<int> symmetryClass;   // -1 if alone
+    struct Optimistic {
+        Fixed value;
+        int column;
+    };
+    vector<vector<Optimistic>> optimistic;  // best first
+    vector<vector<Fixed>> minPenalty;  // by number of shifts, the least any
+                                       // of the worker's schedules pays
+    // by worker * columns.size() + column, if available
+    vector<Fixed> truePriorities;
+    vector<Fixed> optimisticValues;  // as in optimistic
+    vector<TimeSlotNode *> slots;
+
+    // one thread's place in the tree, changed in place and undone
+    struct SearchState {
+        vector<uint64_t> assigned;  // by worker, columns
+        vector<int> counts;
+        vector<int> remaining;      // unfilled columns each is available in
+        vector<Fixed> daySums;      // by worker * NUM_DAYS + day
+        vector<Fixed> workerSums;
+        vector<Fixed> dayGross;     // as daySums, without the penalties
+        vector<Fixed> workerGross;
+        Fixed total = 0;
+        vector<uint64_t> members;   // by column, workers
+        unsigned long long nodes = 0;
+    };
+
+    // the subtree under the first columns filled with prefix
+    struct Task {
+        vector<uint64_t> prefix;
+        double bound;
+        bool done = false;
+    };
+    static const int TASKS_PER_THREAD = 64;  // subtrees differ a lot in size
+    vector<Task> tasks;
+    int taskDepth;   // columns filled by every task's prefix
+    int splitDepth;  // where tasks are collected, -1 while searching
+
+    atomic<double> incumbentScore;
+    int incumbentRange;   // -1 until one is offered
+    double heuristicScore;
+    int incumbentsOffered;
+    mutex bestLock;
+    vector<uint64_t> bestMembers;  // by column
+
+    atomic<bool> stopped;
+    unsigned long long nodes;
+    int tasksDone;
+    double secondsTaken;
+
+    void findMinPenalties();
+    // the candidates of one column for bound
+    static constexpr double MAX_GROUPS = 64;
+    struct GroupBound {
+        int needed;
+        int numCandidates;
+        int workers[MAX_WORKERS];
+        Fixed base[MAX_WORKERS];        // priority less the penalty so far
+        Fixed optimistic[MAX_WORKERS];  // with every bonus the slot could get
+        Fixed best;
+    };
+
+    void initState(SearchState &state) const;
+    void apply(SearchState &state, int depth, uint64_t chosen) const;
+    void undo(SearchState &state, int depth, uint64_t chosen) const;
+    void updateDay(SearchState &state, int worker, int day) const;
+
+    bool bookingRange(const SearchState &state, int &maxBooking,
+                      int &minBooking) const;
+    double bound(const SearchState &state, int depth) const;
+    Fixed bestGroup(GroupBound &group) const;
+    void searchGroups(GroupBound &group, int start, int taken,
+                      uint64_t members, Fixed base) const;
+    double score(const SearchState &state, int &range) const;
+
+    void search(SearchState &state, int depth, const atomic<bool> &keepGoing);
+    void chooseWorkers(SearchState &state, int depth, size_t next, int needed,
+                       uint64_t chosen, const atomic<bool> &keepGoing);
+    void offerLeaf(const SearchState &state);
+    void runTask(Task &task, SearchState &state, const atomic<bool> &keepGoing);
+};
+
+#endif
@@ -0,0 +1,35 @@
+// Fixed point representation of priorities, bonuses, penalties and path values
+
+#ifndef FIXED_SCORE_H
+#define FIXED_SCORE_H
+
+#include <stdint.h>
+
+// A Fixed is a number in units of 2^-FIXED_BITS. Sums of them are exact and
+// do not depend on the order they are added in, so every comparison of
+// priorities or path values comes out the same on any compiler or machine.
+//
+// Tolerance against calculating in doubles: each input value is rounded to
+// the nearest unit, at most 2^-41 (about 4.5e-13) away. A sum of n of them is
+// within n times that, so scores agree with a double calculation to about
+// 1e-10 on any realistic roster, and the choices made only differ where two
+// doubles would have been within that distance of each other.
+//
+// Values must stay below FIXED_LIMIT in size, which input priorities are
+// checked against when they are read.
+typedef int64_t Fixed;
+
+static const int FIXED_BITS = 40;
+static constexpr Fixed FIXED_ONE = (Fixed) 1 << FIXED_BITS;
+static constexpr double FIXED_LIMIT = (double) ((Fixed) 1 << (62 - FIXED_BITS));
+
+// rounds to the nearest unit
+constexpr Fixed toFixed(double value) {
+    return (Fixed) (value * FIXED_ONE + (value < 0 ? -0.5 : 0.5));
+}
+
+constexpr double fromFixed(Fixed value) {
+    return (double) value / FIXED_ONE;
+}
+
+#endif
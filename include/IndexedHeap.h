@@ -0,0 +1,50 @@
+// Max heap over dense integer ids, with increase-key and a clear that only
+// touches the ids that were pushed since the last clear
+
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <stddef.h>
+
+#include <utility>
+#include <vector>
+
+#include "FixedScore.h"
+
+using namespace std;
+
+class IndexedHeap {
+public:
+    IndexedHeap();
+
+    void resize(int numIds);
+    void clear();
+
+    bool empty() const;
+    bool contains(int id) const;
+    Fixed getKey(int id) const;
+
+    void push(int id, Fixed key);
+    void increaseKey(int id, Fixed key);
+    pair<Fixed, int> pop();  // largest key, ties go to the smaller id
+
+private:
+    static const int ARITY = 4;  // shallower than binary, better cache use
+
+    // keys live next to ids so that comparing the children of a node reads
+    // a single cache line
+    struct Entry {
+        Fixed key;
+        int id;
+    };
+
+    static bool higher(const Entry &first, const Entry &second);
+    void siftUp(int index);
+    void siftDown(int index);
+    void place(int index, const Entry &entry);
+
+    vector<Entry> heap;    // entries in heap order
+    vector<int> position;  // index of each id in heap, -1 if not in it
+};
+
+#endif
@@ -0,0 +1,70 @@
+// The schedules of a sweep that no other schedule beats on every part of the
+// score at once
+
+#ifndef PARETO_ARCHIVE_H
+#define PARETO_ARCHIVE_H
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Perturbation.h"
+
+using namespace std;
+
+// a seed's result, by the parts getScore combines
+struct ParetoPoint {
+    double average = 0;
+    double lowest = 0;
+    int range = 0;
+    double score = 0;        // with the input's proportions
+    unsigned int seed = 0;
+    Perturbation perturbation;  // the seed's, to run it again
+};
+
+// A point dominates another if it is at least as good on the average, the
+// lowest and the range and differs on one. The range is better in the
+// direction the score counts it: larger when its proportion is positive, as
+// in ScheduleData.h, smaller otherwise. Any weighting with the same signs
+// picks its best seed from the front.
+//
+// Ranges take few values, so the front is kept by range, and within one
+// range as a staircase: by average increasing, the lowest decreasing. Whether
+// a point is dominated is then one lookup per range at least as good, and the
+// points it dominates are next to each other in every range no better. Equal
+// points keep the lower seed, so the front does not depend on the order
+// seeds finish in. Safe to offer from several threads at once
+class ParetoArchive {
+public:
+    ParetoArchive(bool newEnabled, bool newLargerRangeBetter);
+
+    bool isEnabled() const;
+
+    bool offer(const ParetoPoint &point);  // true if it is on the front now
+
+    vector<ParetoPoint> getFront() const;  // best range first, then average
+    int size() const;
+    unsigned long long getOffered() const;
+
+    void write(const string &fileName) const;
+
+private:
+    bool enabled;
+    bool largerRangeBetter;
+    mutable mutex lock;
+    unsigned long long offered;
+
+    typedef map<double, ParetoPoint> Staircase;  // by average
+    map<int, Staircase> fronts;  // by rangeKey, the best range first
+    int numPoints;
+
+    int rangeKey(int range) const;
+    bool dominatedLocked(const ParetoPoint &point) const;
+    void removeDominatedLocked(const ParetoPoint &point);
+};
+
+#endif
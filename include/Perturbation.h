@@ -0,0 +1,17 @@
+// How a seed's run is randomized besides its seed
+
+#ifndef PERTURBATION_H
+#define PERTURBATION_H
+
+#include "Construction.h"
+
+// noise is uniform in [0, 1 / divisor) and added to every normalized priority.
+// The default only breaks ties
+static const double DEFAULT_NOISE_DIVISOR = 1'000'000;
+
+struct Perturbation {
+    Construction construction = Construction::RANDOM;
+    double noiseDivisor = DEFAULT_NOISE_DIVISOR;
+};
+
+#endif
@@ -0,0 +1,55 @@
+// Picks the perturbation of every seed of a sweep from how well each did
+
+#ifndef PERTURBATION_BANDIT_H
+#define PERTURBATION_BANDIT_H
+
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include "Perturbation.h"
+
+using namespace std;
+
+// A discounted UCB1 bandit over every (construction, noise level) pair. The
+// reward of a seed is the share of the last WINDOW scores it beat, 0 if it
+// was pruned or skipped as a repeat. Older rewards fade by DISCOUNT per seed,
+// so the choice follows which arms do well now, not early in the sweep.
+// With one thread the choices only depend on the scores, so a sweep is the
+// same every time; with more they depend on the order seeds finish in.
+// Safe to use from several threads at once
+class PerturbationBandit {
+public:
+    PerturbationBandit();
+
+    int choose();
+    const Perturbation &getArm(int arm) const;
+    void reward(int arm, double score);  // score < 0 if it has none
+
+    void print(ostream &output) const;
+
+private:
+    static const int NUM_NOISE_LEVELS = 5;
+    static const double NOISE_LEVELS[NUM_NOISE_LEVELS];
+    static constexpr double DISCOUNT = 0.998;
+    static const int WINDOW = 256;
+
+    struct ArmStats {
+        double weight = 0;      // discounted number of rewards
+        double rewardSum = 0;   // discounted
+        unsigned int seeds = 0;
+        double totalReward = 0; // not discounted, for printing
+        double bestScore = -1.0;
+    };
+
+    vector<Perturbation> arms;
+    vector<ArmStats> stats;
+    double totalWeight;
+    vector<double> recentScores;  // ring buffer of the last WINDOW
+    size_t nextRecent;
+    mutable mutex lock;
+
+    double rank(double score) const;
+};
+
+#endif
@@ -0,0 +1,49 @@
+// Batch kernels over contiguous arrays of priorities, indexed by slot id
+
+#ifndef PRIORITY_KERNELS_H
+#define PRIORITY_KERNELS_H
+
+#include <stddef.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "FixedScore.h"
+
+using namespace std;
+
+// Every kernel has an AVX2 version, used when the CPU running the program
+// supports it, and a scalar one for every other machine. Both give exactly
+// the same results, so a seed's schedule does not depend on which one ran.
+class PriorityKernels {
+public:
+    static bool usingAvx2();
+
+    // out[i] = base[i] + toFixed(noise[i] / divisor). noise[i] / divisor must
+    // be below 2^(51 - FIXED_BITS) in size
+    static void addNoise(const Fixed *base, const double *noise, double divisor,
+                         Fixed *out, size_t n);
+
+    // smallest and largest value, {0, 0} if n is 0
+    static pair<Fixed, Fixed> findMinMax(const Fixed *values, size_t n);
+
+    // (values[i] - low) / (high - low) for values in [low, high], high > low
+    static void normalize(Fixed *values, size_t n, Fixed low, Fixed high);
+
+    // sums[i] = the sum of values[offsets[i]] up to values[offsets[i + 1]]
+    static void segmentSums(const Fixed *values, const int *offsets,
+                            size_t numSegments, Fixed *sums);
+
+private:
+    struct Table {
+        bool avx2;
+        void (*addNoise)(const Fixed *, const double *, double, Fixed *, size_t);
+        pair<Fixed, Fixed> (*findMinMax)(const Fixed *, size_t);
+        void (*normalize)(Fixed *, size_t, Fixed, Fixed);
+        void (*segmentSums)(const Fixed *, const int *, size_t, Fixed *);
+    };
+
+    static const Table &table();
+};
+
+#endif
@@ -0,0 +1,63 @@
+// Command line options for the Worker Scheduler driver
+
+#ifndef RUN_OPTIONS_H
+#define RUN_OPTIONS_H
+
+#include <limits.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Perturbation.h"
+#include "Validation.h"
+
+using namespace std;
+
+struct RunOptions {
+    string inputPath;
+
+    bool merge = false;         // "merge" subcommand
+    vector<string> mergeFiles;  // shard result files to merge
+
+    bool singleSeed = false;    // --seed=
+    unsigned int seed = 1;
+
+    unsigned int firstSeed = 1;           // --seed-range=START:END
+    unsigned int lastSeed = UINT_MAX - 1; // (inclusive)
+
+    string resultOut;  // --result-out=
+
+    int searchThreads = 1;  // --search-threads=, threads inside one seed
+    bool batchBalance = false;  // --batch-balance
+
+    // --construction=NAME, or --construction=portfolio to take turns by seed
+    Construction construction = Construction::RANDOM;
+    bool portfolio = false;
+    double noiseDivisor = DEFAULT_NOISE_DIVISOR;  // --noise=X is 1 / X
+    bool adaptive = false;  // --adaptive, picks both per seed while sweeping
+    string seedLog;         // --seed-log=FILE, one line per seed swept
+    string paretoOut;       // --pareto=FILE, the seeds no other seed beats
+
+    bool skipRepeats = false;  // --skip-repeats, of an initial allocation
+
+    double gap = -1;  // --gap=, stop within this of the score bound if >= 0
+
+    int threads = 1;     // --threads=, threads sweeping seeds
+    bool presolve = false;          // --presolve
+    bool components = false;        // --components, sweep each on its own
+    Validation validation = DEFAULT_VALIDATION;  // --validate=off|fast|full
+
+    double pruneSafety = 0;  // --prune[=SAFETY], give up on hopeless seeds
+
+    int refine = 0;  // --lns=N, neighborhoods to rebuild in the best result
+    int elite = 0;   // --elite[=K], best distinct schedules to relink
+    bool exact = false;  // --exact, branch and bound instead of a sweep
+    string scenarioFile; // --scenarios=FILE, what-if variations to compare
+};
+
+RunOptions parseRunOptions(int argc, char *argv[]);
+void printUsage(ostream &output);
+
+#endif
@@ -0,0 +1,88 @@
+// Sweeps seeds over what-if variations of the input and compares the best
+// schedule of each
+
+#ifndef SCENARIO_SWEEP_H
+#define SCENARIO_SWEEP_H
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "RunOptions.h"
+#include "ScheduleData.h"
+#include "Scheduler.h"
+#include "ScoreWeights.h"
+#include "SeedSweep.h"
+#include "ThreadPool.h"
+#include "WorkerInputData.h"
+
+using namespace std;
+
+// A scenario file lists scenarios, each a "[name]" line followed by what it
+// changes, one change per line:
+//     shift DAY SHIFT N    the shift needs N workers. DAY or SHIFT can be
+//                          "all"
+//     NAME VALUE           a penalty, bonus or proportion, named as in
+//                          ScheduleData.h
+// Blank lines and lines starting with '#' are skipped. Every scenario starts
+// from the input as read, and a baseline without changes is always swept
+// first. The input is read once; each scenario gets its own copy, with its
+// own weights, so they are swept at once (--threads) like components.
+class ScenarioSweep {
+public:
+    ScenarioSweep(WorkerInputData &data, const RunOptions &options,
+                  ThreadPool *newPool);
+
+    int getNumScenarios() const;
+
+    void run(const atomic<bool> &keepGoing);
+
+    void printScenarios(ostream &output) const;
+    void printTable(ostream &output) const;
+    void printProfile(ostream &output) const;
+
+private:
+    struct Scenario {
+        string name;
+        vector<string> changes;  // as written in the file
+        struct Staffing {
+            int day;    // -1 for all
+            int shift;  // -1 for all
+            int needed;
+        };
+        vector<Staffing> staffing;
+        vector<pair<Weight, double>> weights;
+
+        // the best schedule of the sweep, run again once it is done
+        unsigned int bestSeed = 0;
+        unsigned int seedsChecked = 0;
+        double score = 0;
+        double average = 0;
+        double lowest = 0;
+        int range = 0;
+    };
+
+    WorkerInputData &inputData;
+    RunOptions scenarioOptions;  // each scenario's sweep runs on one thread
+    ThreadPool *pool;            // searches inside each seed, or null
+    int numThreads;              // scenarios swept at once
+
+    vector<Scenario> scenarios;  // the baseline first
+    vector<unique_ptr<WorkerInputData>> scenarioData;
+    vector<unique_ptr<SeedSweep>> sweeps;
+    double secondsTaken;
+
+    void readScenarios(const string &fileName);
+    void readChange(Scenario &scenario, const string &line);
+    void apply(const Scenario &scenario, WorkerInputData &data);
+    void runScenario(int index, const atomic<bool> &keepGoing);
+};
+
+#endif
@@ -4,22 +4,32 @@
 #define SCHEDULER_H
 
 #include <limits.h>
-#include <stdlib.h>  // rand()
-#include <random>
 
 #include <algorithm>
+#include <bitset>
+#include <chrono>
 #include <fstream>
+#include <functional>
 #include <iostream>
-#include <queue>
+#include <limits>
 #include <string>
 #include <unordered_set>
 #include <vector>
 
+#include "Construction.h"
+#include "CounterRandom.h"
+#include "ElitePool.h"
+#include "IndexedHeap.h"
+#include "Perturbation.h"
+#include "PriorityKernels.h"
+#include "ThreadPool.h"
 #include "WorkerNode.h"
 #include "TimeSlotNode.h"
 #include "ScheduleData.h"
 #include "WorkerInputData.h"
 #include "PrintSchedule.h"
+#include "SeedPruner.h"
+#include "Validation.h"
 
 using namespace std;
 
@@ -27,14 +37,40 @@ class Scheduler {
 public:
     /******************************* Constructor ******************************/
     Scheduler(WorkerInputData &data, unsigned int newSeed);
+    void reset(unsigned int newSeed);
+    void setThreadPool(ThreadPool *newPool);
+    void setBatchBalance(bool newValue);
+    void setConstruction(Construction newConstruction);
+    void setNoiseDivisor(double newDivisor);
+    void setPerturbation(const Perturbation &perturbation);
+    void setPruner(SeedPruner *newPruner);
+    void setValidation(Validation newValidation);
 
     /*************************** Schedule Population **************************/
     void calculate();
+    void construct();
+    void balance();
+    void loadSchedule(const vector<TimeSlotNode *> &slots);
+
+    /******************************* Refinement *******************************/
+    void refine(int iterations);
+    bool relink(const vector<int> &guide, EliteSchedule &best);
+    void snapshot(EliteSchedule &out, double score) const;
 
     /******************************* Statistics *******************************/
     double getAverage();
     int getRange();
     double getLeastHappy();
+    double getScore();
+    unsigned int getSeed() const;
+    Construction getConstruction() const;
+    Perturbation getPerturbation() const;
+    uint64_t getStateHash() const;
+    int getBalanceIterations() const;
+    bool getAbandoned() const;
+    const vector<double> &getCheckpointScores() const;
+
+    const vector<vector<vector<TimeSlotNode *>>> &getFinalSchedule() const;
 
     /******************************** Printing ********************************/
     void printStats(ostream &output);
@@ -45,6 +81,7 @@ public:
     void printWorkers(ostream &output);
     void printWorkerShifts(ostream &output);
     void printWorkerShiftNum(ostream &output);
+    void printRefineStats(ostream &output);
 
 private:
     WorkerInputData &inputData;
@@ -52,43 +89,177 @@ private:
 
     vector<vector<vector<TimeSlotNode *>>> finalSchedule = vector<vector<vector<TimeSlotNode *>>>(NUM_DAYS, vector<vector<TimeSlotNode *>>(MAX_SHIFTS));
 
-    const double tinyChangeDivisor = 1'000'000;
+    double noiseDivisor;  // noise is uniform in [0, 1 / noiseDivisor)
     bool calculated;    // whether schedule has been calculated
     unsigned int seed;  // seed of this run
 
+    // independent random streams drawn from rng
+    static const uint64_t NOISE_STREAM = 0;
+    static const uint64_t SHUFFLE_STREAM = 1;
+    static const uint64_t WORKER_STREAM = 2;
+    CounterRandom rng;
+    vector<double> tinyChanges;  // noise per slot id
+    vector<Fixed> truePriorities;  // by slot id, the same for every seed
+    vector<Fixed> priorities;      // by slot id, with the seed's noise
+
+    // findAverage: the allocations of every worker, one after the other
+    vector<Fixed> allocationValues;
+    vector<int> allocationOffsets;  // by worker id, then the total at the end
+    vector<Fixed> workerSums;       // by worker id
+
+    // Keys are per (symmetry class, shift), so interchangeable workers share
+    // them, and the state hash adds up a mix of each worker's xor of keys.
+    // A schedule that only swaps interchangeable workers hashes the same
+    static const uint64_t ZOBRIST_KEY = 0x5EED5EED;
+    vector<uint64_t> slotKeys;      // by slot id
+    vector<uint64_t> workerHashes;  // by worker id, xor of their allocations' keys
+    vector<int> twinClasses;        // by worker id, -1 if in a class alone
+    uint64_t stateHash;             // updated by addAllocation/removeAllocation
+
+    // scratch space kept between seeds so that a reset run does not allocate
+    vector<pair<int, int>> shiftOrder;
+    vector<TimeSlotNode *> topPriority;
+    vector<Fixed> topKeys;  // priority of each of topPriority
+
+    Construction construction;
+    static constexpr Fixed FILLED = -1;  // regret of a shift already filled
+    vector<Fixed> regrets;               // by day * MAX_SHIFTS + shift
+    vector<WorkerNode *> workerOrder;
+    vector<TimeSlotNode *> bestPath;
+
+    // one bit per (day, shift). A search that found no path only read the
+    // shifts it scanned and the workers available in them, so a path that
+    // touches none of those cannot have opened one
+    typedef bitset<NUM_DAYS * MAX_SHIFTS> ColumnMask;
+    vector<ColumnMask> availableColumns;  // by worker id
+    vector<ColumnMask> searchedColumns;   // by worker id, from its last search
+    ColumnMask changedColumns;            // since noPath was last updated
+
+    // initialOneSlot: priorities of the unused slots of the current shift
+    IndexedHeap candidates;             // keyed by slot id
+    vector<TimeSlotNode *> shiftSlot;   // by worker id, in the current shift
+    // of interchangeable workers with the same allocations, only the first
+    // is a candidate, and the next one once it is allocated
+    vector<int> nextTwin;               // by slot id, or -1
+    vector<pair<int, int>> twinChains;  // first and last slot id of each chain
+    vector<vector<int>> likedBy;        // by worker id, ids of who likes them
+
+    // marks for one findPath search, plus the best path that thread found in
+    // the current searchWorker. One per thread so that searches from each
+    // allocation of a worker can run at the same time
+    struct SearchScratch {
+        vector<char> seen;     // by slot id
+        vector<int> prev;      // slot id before this one on its path, or -1
+        vector<int> touched;   // slot ids marked seen, cleared next search
+        IndexedHeap paths;     // open path ends, keyed by slot id
+        ColumnMask searched;   // shifts whose neighbors were scanned
+
+        bool foundPath;
+        Fixed bestPathVal;
+        size_t bestBlock;      // index of the allocation the path starts at
+        vector<TimeSlotNode *> bestPath;
+    };
+    vector<SearchScratch> scratches;
+    ThreadPool *pool;  // runs searches in parallel if not null
+
+    Validation validation;
+    vector<unsigned int> workerStamps;  // by worker id, for validation
+
+    // checkpoints in graphBalance at which a hopeless seed is given up
+    static const int CHECKPOINT_INTERVAL = 4;  // balance iterations
+    SeedPruner *pruner;       // null if seeds are never given up
+    bool abandoned;                   // this seed was given up
+    vector<double> checkpointScores;  // of this seed, in order
+
+    // batched graphBalance: paths from several overbooked workers per round
+    bool batchBalance;
+    int balanceIterations;             // rounds of graphBalance this run
+    vector<WorkerNode *> batchWorkers; // overbooked workers this round
+    vector<unsigned int> workerLock;   // round a worker was last on a path
+    unsigned int lockRound;
+
+    // refine: each iteration empties the shifts of one neighborhood
+    enum Neighborhood {DAY, COLUMN, COWORKERS, NUM_NEIGHBORHOODS};
+    static const uint64_t REFINE_STREAM = 1ULL << 32;  // plus the iteration
+    bool journaling;
+    vector<pair<TimeSlotNode *, bool>> journal;  // true if added, this iteration
+    vector<int> refineShifts;   // day * MAX_SHIFTS + shift, to fill again
+    vector<char> shiftEmptied;  // by day * MAX_SHIFTS + shift
+    struct RefineStats {
+        int tried[NUM_NEIGHBORHOODS] = {};
+        int improved[NUM_NEIGHBORHOODS] = {};  // score went up
+        int kept[NUM_NEIGHBORHOODS] = {};      // score stayed the same
+        double startScore = 0;
+        double endScore = 0;
+        double seconds = 0;
+    };
+    RefineStats refineStats;
+
+    // relink: the guide's slots, by slot id and grouped by shift
+    vector<char> inGuide;
+    vector<vector<TimeSlotNode *>> guideShifts;  // by day * MAX_SHIFTS + shift
+
 
     /******************************* Constructor ******************************/
-    void addTinyPriorityChange(unsigned int randSeed);
+    void addTinyPriorityChange();
 
     /*************************** Schedule Population **************************/
     void addAllocation(TimeSlotNode *toAssign);
     void removeAllocation(TimeSlotNode *toRemove);
 
     void initialAllocation();
+    void allocateByRegret();
+    Fixed shiftRegret(int day, int shift);
+    void allocateScarceWorkers();
     void initialOneSlot(const vector<TimeSlotNode *> &currQueue);
-    TimeSlotNode *findMaxTimeSlotPriority(const vector<TimeSlotNode *> &currQueue);
+    bool deferTwin(TimeSlotNode *slot);
+    bool twins(int worker1, int worker2) const;
+    TimeSlotNode *findMaxTimeSlotPriority();
 
     void graphBalance();
     bool findMinMaxWorkerBooking(WorkerNode **min, WorkerNode **max);
+    bool checkpoint();
+
+    void balanceBatch(WorkerNode *min);
+    void collectOverbooked(int minBooking);
+    void lockPathWorkers(const vector<TimeSlotNode *> &path);
+    bool locked(WorkerNode *worker) const;
+    static bool moreOverbooked(WorkerNode *w1, WorkerNode *w2);
 
     bool searchWorker(WorkerNode *currWorker);
-    void resetSearchValues();
+    bool findWorkerPath(WorkerNode *currWorker, vector<TimeSlotNode *> &path);
+    void searchBlock(TimeSlotNode *block, size_t blockIndex, SearchScratch &scratch);
+    void resetSearchValues(SearchScratch &scratch);
     void resetNoPath();
-    pair<double, TimeSlotNode *> findPath(TimeSlotNode *overbooked);
-    void findNodeToAdd(priority_queue<pair<double, TimeSlotNode *>> &paths, pair<double, TimeSlotNode *> &bestPath, pair<double, TimeSlotNode *> currPath, TimeSlotNode *start);
-    void findNodeToDrop(priority_queue<pair<double, TimeSlotNode *>> &paths, TimeSlotNode *neighbor, double currPathValue);
+    static int column(const TimeSlotNode *slot);
+    pair<Fixed, TimeSlotNode *> findPath(TimeSlotNode *overbooked, SearchScratch &scratch);
+    void findNodeToAdd(pair<Fixed, TimeSlotNode *> &bestPathEnd, pair<Fixed, TimeSlotNode *> currPath, TimeSlotNode *start, SearchScratch &scratch);
+    void findNodeToDrop(TimeSlotNode *neighbor, Fixed currPathValue, SearchScratch &scratch);
+    void markSeen(TimeSlotNode *slot, TimeSlotNode *prev, SearchScratch &scratch);
     bool validPath(TimeSlotNode *start, TimeSlotNode *end);
 
-    void buildPath(vector<TimeSlotNode *> &path, TimeSlotNode *end);
+    void buildPath(vector<TimeSlotNode *> &path, TimeSlotNode *end, SearchScratch &scratch);
     void makeChanges(vector<TimeSlotNode *> &path);
+    void applyPath(vector<TimeSlotNode *> &path);
     void resetAllMemoizedPriorities();
 
+    /******************************* Refinement *******************************/
+    void destroyNeighborhood(Neighborhood kind, uint64_t stream);
+    void emptyShift(int day, int shift);
+    void repairNeighborhood(uint64_t stream);
+    void undoJournal();
+    bool nextRelinkSwap(TimeSlotNode **out, TimeSlotNode **in);
+    void clearNoPath();
+    static string neighborhoodName(Neighborhood kind);
+
 
     /******************************* Validation *******************************/
     void validateSolution();
     void validateWorkersOnShift();
     void validateNoDuplicateWorkers();
     void validateUsed();
+    void validateWorkers();
+    void validateStateHash();
 
     /******************************* Statistics *******************************/
     double findAverage(int &leastIndex,
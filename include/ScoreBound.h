@@ -0,0 +1,59 @@
+// Upper bound on the score any schedule of the input can reach, calculated
+// once at load time so that a sweep knows how far from optimal its best is
+
+#ifndef SCORE_BOUND_H
+#define SCORE_BOUND_H
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+#include "ScheduleData.h"
+#include "TimeSlotNode.h"
+#include "WorkerInputData.h"
+#include "WorkerNode.h"
+
+using namespace std;
+
+class ScoreBound {
+public:
+    ScoreBound(WorkerInputData &data);
+
+    double getAverageBound() const;
+    double getLowestBound() const;
+    int getRangeBound() const;
+    double getScoreBound() const;
+
+    double gap(double score) const;  // how far the bound is above score
+
+    void print(ostream &output) const;
+
+private:
+    double averageBound;
+    double lowestBound;
+    int rangeBound;
+    double scoreBound;
+
+    // shifts with more ways to pick their workers than this use the looser
+    // bound of each candidate on their own
+    static constexpr double MAX_GROUPS = 100'000;
+
+    struct GroupSearch {
+        int taken;               // workers the shift needs
+        vector<double> priority; // by candidate
+        vector<double> likes;    // bonus of [i * candidates + j] for i liking j
+        vector<int> group;       // candidates picked so far
+        double best;
+    };
+
+    static double slotBound(TimeSlotNode *slot, WorkerInputData &data);
+    static double shiftBound(const vector<TimeSlotNode *> &available, 
+                             int taken, WorkerInputData &data);
+    static void searchGroups(GroupSearch &search, int start, double value);
+    void boundAverageAndLowest(WorkerInputData &data);
+};
+
+#endif
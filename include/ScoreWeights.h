@@ -0,0 +1,67 @@
+// The penalties, bonus and score proportions of ScheduleData.h, held by every
+// copy of the input so that a copy can score with other values
+
+#ifndef SCORE_WEIGHTS_H
+#define SCORE_WEIGHTS_H
+
+#include <math.h>
+
+#include <array>
+#include <stdexcept>
+#include <string>
+
+#include "FixedScore.h"
+#include "ScheduleData.h"
+
+using namespace std;
+
+enum class Weight {
+    DOUBLE_SHIFT_PENALTY,
+    DOUBLE_DAY_PENALTY,
+    COWORKER_BONUS,
+    AVERAGE_PROPORTION,
+    LOWEST_PROPORTION,
+    RANGE_PROPORTION
+};
+
+static const int NUM_WEIGHTS = 6;
+
+// named as in ScheduleData.h
+string weightName(Weight weight);
+bool parseWeight(const string &name, Weight &weight);
+
+class ScoreWeights {
+public:
+    // penalties and the bonus are never negative, the bounds rely on it.
+    // Priorities are normalized to 0..1, so this is far beyond any use
+    static constexpr double MAX_PENALTY = 1000;
+
+    ScoreWeights();  // the values in ScheduleData.h
+
+    double get(Weight weight) const;
+    void set(Weight weight, double value);
+
+    double getAverageProportion() const;
+    double getLowestProportion() const;
+    double getRangeProportion() const;
+    double getCoworkerBonus() const;
+
+    // what a slot loses or gains, by how many of the worker's other shifts
+    // are on its day and how many liked coworkers share it
+    Fixed penaltyFor(int numDoubleDay, int numDoubleShift) const;
+    Fixed bonusFor(int numLiked) const;
+
+private:
+    double values[NUM_WEIGHTS];
+
+    // a worker has at most MAX_SHIFTS - 1 other shifts on the same day, so
+    // the penalty for every count is calculated once instead of calling pow
+    // each time
+    array<Fixed, MAX_SHIFTS> doubleDayPenalties;
+    array<Fixed, MAX_SHIFTS> doubleShiftPenalties;
+    Fixed coworkerBonus;
+
+    void buildTables();
+};
+
+#endif
@@ -0,0 +1,48 @@
+// Best score shared by every thread of a sweep, and the decision to give up on
+// a seed part way through graphBalance
+
+#ifndef SEED_PRUNER_H
+#define SEED_PRUNER_H
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+using namespace std;
+
+// graphBalance can move any shift, so there is no bound on how much it can
+// still improve a schedule that holds for every input. The bounds used are
+// learned instead: for each checkpoint, the largest gain any complete seed
+// made from that checkpoint to its final score. A seed is hopeless once its
+// checkpoint score plus safety times that gain is below the best score
+class SeedPruner {
+public:
+    SeedPruner(double newSafety);  // 0 never gives up on a seed
+
+    bool isEnabled() const;
+
+    bool offerBest(double score);  // true if score is the new best
+    double getBest() const;        // below 0 until a seed was scored
+
+    void recordGains(double finalScore, const vector<double> &checkpointScores);
+    bool hopeless(size_t checkpoint, double checkpointScore) const;
+
+    static constexpr size_t MAX_CHECKPOINTS = 64;  // later ones share the last
+
+private:
+    // complete seeds that reached a checkpoint before its gain is trusted
+    static const unsigned int WARMUP_SEEDS = 32;
+
+    struct LearnedGain {
+        atomic<double> maxGain;
+        atomic<unsigned int> seeds;
+    };
+
+    // the largest gain seen so far underestimates the largest possible one,
+    // so it is scaled up by this
+    double safety;
+    atomic<double> best;
+    LearnedGain gains[MAX_CHECKPOINTS];
+};
+
+#endif
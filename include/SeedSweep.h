@@ -0,0 +1,137 @@
+// Runs the Scheduler over a range of seeds and keeps track of the best one
+
+#ifndef SEED_SWEEP_H
+#define SEED_SWEEP_H
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "ElitePool.h"
+#include "ParetoArchive.h"
+#include "PerturbationBandit.h"
+#include "RunOptions.h"
+#include "Scheduler.h"
+#include "ScoreBound.h"
+#include "SeedPruner.h"
+#include "StateSet.h"
+#include "ThreadPool.h"
+#include "WorkerInputData.h"
+
+using namespace std;
+
+class SeedSweep {
+public:
+    SeedSweep(WorkerInputData &data, const RunOptions &newOptions,
+              ThreadPool *newPool);
+
+    static void configureScheduler(Scheduler &scheduler,
+                                   const RunOptions &options,
+                                   ThreadPool *pool);
+    static Perturbation perturbationFor(const RunOptions &options,
+                                        unsigned int seed);
+
+    void setLabel(const string &newLabel);
+    void run(const atomic<bool> &keepGoing);
+
+    unsigned int getBestSeed() const;
+    Perturbation getBestPerturbation() const;
+    unsigned int getSeedsChecked() const;
+    double getBestScore() const;
+    const EliteSchedule *getRelinkedBest() const;
+
+    void printProfile(ostream &output) const;
+    void printConstructionStats(ostream &output) const;
+
+private:
+    WorkerInputData &inputData;
+    const RunOptions &options;
+    ThreadPool *pool;  // shared by the searches inside each seed, or null
+    string label;      // put in front of every progress message
+
+    unsigned int firstSeed;
+    unsigned int lastSeed;  // inclusive
+
+    ScoreBound bound;  // no seed can score above this
+
+    // shared by the sweeping threads (--threads)
+    atomic<unsigned long long> seedsHandedOut;
+    atomic<bool> withinGap;
+    SeedPruner pruner;  // best score so far, gives up on hopeless seeds
+    mutex printLock;
+    PerturbationBandit bandit;  // with --adaptive
+    ofstream seedLog;           // with --seed-log
+    ParetoArchive pareto;       // with --pareto
+    mutex logLock;
+
+    // hashes of the schedules after construction and after balancing. Only
+    // 2^STATE_SET_LOG2 are remembered, so very long sweeps undercount
+    static const int STATE_SET_LOG2 = 18;
+    StateSet startStates;
+    StateSet finalStates;
+
+    // how each construction did. A win is a seed that beat every seed
+    // scored before it
+    struct ConstructionStats {
+        unsigned int seeds = 0;
+        unsigned int wins = 0;
+        double scoreSum = 0;
+        double bestScore = -1.0;
+    };
+
+    // what one sweeping thread counted, added up once all of them are done
+    struct Tally {
+        unsigned int bestSeed = 0;
+        Perturbation bestPerturbation;  // needed with --adaptive to run it again
+        double bestScore = -1.0;
+        unsigned int seedsChecked = 0;
+        unsigned long long balanceIterations = 0; // summed over balanced seeds
+
+        unsigned int repeatedStarts = 0;
+        unsigned int repeatedFinals = 0;
+        unsigned int seedsSkipped = 0;  // with --skip-repeats
+
+        unsigned int seedsPruned = 0;   // with --prune
+        double completeSeconds = 0;     // in seeds that were scored
+        double prunedSeconds = 0;       // in seeds that were given up
+
+        ConstructionStats constructionStats[NUM_CONSTRUCTIONS];
+    };
+    Tally total;
+    double secondsTaken;
+
+    // --elite: the best distinct schedules of every thread, relinked in
+    // pairs once the sweep is done. Rounds stop once one adds nothing
+    static const int MAX_RELINK_ROUNDS = 4;
+    ElitePool elite;
+    int relinkRounds;
+    int relinkPaths;
+    int relinkAdded;        // schedules on a path that made it into the pool
+    double relinkSeconds;
+    bool relinkedBetter;    // the best schedule is not any seed's
+    EliteSchedule relinkedBest;
+
+    unsigned long long firstSeedAllocations; // includes setting up containers
+    unsigned long long laterAllocations;     // all seeds after the first
+
+
+    void sweep(WorkerInputData &data, Tally &tally, 
+               const atomic<bool> &keepGoing);
+    bool nextSeed(unsigned int &seed);
+    double runSeed(Scheduler &scheduler, Tally &tally);
+    void recordResult(Scheduler &scheduler, Tally &tally);
+    void logSeed(const Scheduler &scheduler, double score);
+    void addTally(const Tally &tally);
+    void relinkElite();
+    void printElite(ostream &output) const;
+};
+
+#endif
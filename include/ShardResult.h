@@ -0,0 +1,52 @@
+// Result of sweeping one range of seeds, written to a file so that shards run
+// on different machines can be merged afterwards
+
+#ifndef SHARD_RESULT_H
+#define SHARD_RESULT_H
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ScheduleData.h"
+#include "Scheduler.h"
+
+using namespace std;
+
+class ShardResult {
+public:
+    ShardResult(Scheduler &scheduler, unsigned int newFirstSeed,
+                unsigned int newLastSeed, unsigned int newSeedsChecked);
+    ShardResult(const string &fileName);
+
+    static ShardResult merge(const vector<string> &fileNames);
+
+    bool betterThan(const ShardResult &other) const;
+    void write(const string &fileName) const;
+
+    void printSummary(ostream &output) const;
+    void printAssignment(ostream &output) const;
+
+private:
+    void read(istream &input, const string &fileName);
+    void readAssignment(istream &input, const string &fileName);
+
+    unsigned int firstSeed;
+    unsigned int lastSeed;
+    unsigned int seedsChecked;
+
+    unsigned int bestSeed;
+    double score;
+    double average;
+    double lowest;
+    int range;
+
+    // worker names on each shift, [NUM_DAYS][MAX_SHIFTS]
+    vector<vector<vector<string>>> assignment;
+};
+
+#endif
@@ -0,0 +1,33 @@
+// Bounded set of 64 bit schedule hashes, used to notice repeated states
+
+#ifndef STATE_SET_H
+#define STATE_SET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+// Open addressing over a fixed table. Once the probes for a hash run into
+// full slots the hash is dropped, so a full set forgets instead of growing:
+// it can miss a repeat, but never reports a state it has not seen (up to
+// hash collisions). Slots are atomic so several sweeps can share one set.
+class StateSet {
+public:
+    StateSet(int capacityLog2);
+
+    bool insert(uint64_t hash);  // false if the hash was already in the set
+    size_t getCapacity() const;
+
+private:
+    static const int MAX_PROBES = 16;
+    static const uint64_t EMPTY = 0;
+
+    size_t mask;  // capacity - 1
+    unique_ptr<atomic<uint64_t>[]> slots;
+};
+
+#endif
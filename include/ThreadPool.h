@@ -0,0 +1,56 @@
+// Fixed set of worker threads that run the iterations of a loop in parallel
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class ThreadPool {
+public:
+    ThreadPool(int numThreads);
+    ~ThreadPool();
+
+    int getNumThreads() const;
+
+    // calls task(index, thread) for every index in [0, n) and returns once all
+    // calls are done. thread is in [0, getNumThreads()) and no two calls with
+    // the same thread run at once, so it can index per thread scratch space.
+    // The calling thread works as thread 0. Nothing is allocated per call.
+    template <typename Task>
+    void parallelFor(int n, Task &task) {
+        run(n, &callTask<Task>, &task);
+    }
+
+private:
+    template <typename Task>
+    static void callTask(void *task, int index, int thread) {
+        (*(Task *) task)(index, thread);
+    }
+
+    void run(int n, void (*newFunction)(void *, int, int), void *newTask);
+    void workOn(int thread);
+    void threadLoop(int thread);
+
+    vector<thread> threads;
+
+    mutex lock;
+    condition_variable workReady;
+    condition_variable workDone;
+    unsigned long generation;  // bumped for every parallelFor call
+    int threadsBusy;
+    bool stopping;
+
+    // current loop
+    void (*currFunction)(void *, int, int);
+    void *currTask;
+    int numIndices;
+    atomic<int> nextIndex;
+};
+
+#endif
@@ -3,10 +3,12 @@
 #ifndef TIMESLOTNODE_H
 #define TIMESLOTNODE_H
 
+#include <array>
 #include <iostream>
 #include <vector>
 #include <cmath>
 
+#include "FixedScore.h"
 #include "ScheduleData.h"
 #include "WorkerNode.h"
 
@@ -17,7 +19,7 @@ class WorkerNode; // circular reference shenanigans
 // TODO: make sure the order of this is correct according to the .c file
 class TimeSlotNode {
 public:
-    TimeSlotNode(WorkerNode *newParent, int newDay, int newShift, double newPriority);
+    TimeSlotNode(WorkerNode *newParent, int newDay, int newShift, Fixed newPriority);
 
     void resetRunValues();
 
@@ -27,22 +29,22 @@ public:
     WorkerNode *getParent() const;
 
     void resetMemoizedPriority(const vector<vector<vector<TimeSlotNode *>>> &workers);
-    double getMemoizedPriority(bool useTruePriority) const;
+    Fixed getMemoizedPriority(bool useTruePriority) const;
 
-    double getPriority(const vector<vector<vector<TimeSlotNode *>>> &workers, bool useTruePriority) const;
+    Fixed getPriority(const vector<vector<vector<TimeSlotNode *>>> &workers, bool useTruePriority) const;
 
-    double getTruePriority() const; // todo: turn these to camel case
+    Fixed getTruePriority() const; // todo: turn these to camel case
+    int getId() const;
     int getDay() const;
     int getShift() const;
     bool getUsed() const;
-    bool getSeen() const;
-    TimeSlotNode *getPrev() const;
+    bool getForced() const;
 
-    void setTruePriority(double newPriority);
-    void setPriority(double newPriority);
-    void setSeen(bool newValue);
+    void setId(int newId);
+    void setTruePriority(Fixed newPriority);
+    void setPriority(Fixed newPriority);
     void setUsed(bool newValue);
-    void setPrev(TimeSlotNode *newPrev);
+    void setForced(bool newValue);
 
 
     void printTime(ostream &output) const;
@@ -51,23 +53,21 @@ public:
 
 
 private:
-    double calcPenalty() const;
-    double calcBonus(const vector<vector<vector<TimeSlotNode *>>> &workers) const;
-    double exponeniatePenalty(int times, double factor, double penalty) const;
+    Fixed calcPenalty() const;
+    Fixed calcBonus(const vector<vector<vector<TimeSlotNode *>>> &workers) const;
 
     WorkerNode *parent; // parent worker for this timeslot node
 
-    double truePriority; // change the name of this to normalizedPriority?
-    double priority; // priority after the tiny shift
-    double memoizedPriority;
+    Fixed truePriority; // change the name of this to normalizedPriority?
+    Fixed priority; // priority after the tiny shift
+    Fixed memoizedPriority;
 
+    int id; // dense index into WorkerInputData's slot list
     int day;
     int shift;
 
     bool used;
-    
-    bool seen;
-    TimeSlotNode *prev;
+    bool forced; // always used, found by WorkerInputData::presolve
 };
 
 
@@ -0,0 +1,19 @@
+// How much of a finished schedule the Scheduler checks
+
+#ifndef VALIDATION_H
+#define VALIDATION_H
+
+enum class Validation {
+    OFF,
+    FAST,  // the final assignment only, by worker id
+    FULL   // FAST plus the bookkeeping of every worker and slot
+};
+
+// debug builds (make debug) check everything unless told otherwise
+#ifdef SCHEDULER_DEBUG
+static const Validation DEFAULT_VALIDATION = Validation::FULL;
+#else
+static const Validation DEFAULT_VALIDATION = Validation::FAST;
+#endif
+
+#endif
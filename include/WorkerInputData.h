@@ -3,22 +3,28 @@
 #ifndef WORKER_DATA_H
 #define WORKER_DATA_H
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 
 
+#include "PriorityKernels.h"
 #include "ScheduleData.h"
+#include "ScoreWeights.h"
 #include "TimeSlotNode.h"
 #include "WorkerNode.h"
 
 
 class WorkerInputData {
 public:
-    WorkerInputData(string inputDirectory);
+    WorkerInputData(string inputPath);  // a directory, a bulk file or "-"
     WorkerInputData(const WorkerInputData &other);
+    WorkerInputData(const WorkerInputData &other, const vector<int> &workerIds);
 
     void resetValues();
     ~WorkerInputData();
@@ -26,29 +32,69 @@ public:
     const vector<vector<vector<TimeSlotNode *>>> &getWorkersAvailable();
     const vector<TimeSlotNode *> &getWorkersAvailable(int day, int shift);
     int getWorkersPerShift(int day, int shift);
+    void setWorkersPerShift(int day, int shift, int needed);
+    const ScoreWeights &getWeights();
+    void setWeight(Weight weight, double value);
     vector<WorkerNode *> &getWorkerList();
+    const vector<TimeSlotNode *> &getSlotList();
     WorkerNode *getWorker(int listIndex);
     int getNumWorkers();
 
+    vector<vector<int>> findComponents();
+
+    int getSymmetryClass(int workerId);
+    int getClassSize(int classId);
+    void printSymmetry(ostream &output);
+
+    void presolve();
+    void printPresolve(ostream &output);
+
 
 private:
     vector<vector<int>> workersPerShift; // [NUM_DAYS][MAX_SHIFTS]
+    ScoreWeights weights;  // every worker points to these
     vector<WorkerNode *> workerList;
     vector<vector<vector<TimeSlotNode *>>> workersAvailable; // [NUM_DAYS][MAX_SHIFTS]
+    vector<TimeSlotNode *> slotList; // every timeslot, indexed by slot id
 
-    void normalizePriority();
-    pair<double, double> findMinMaxPriority();
+    // workers that can trade places in any schedule without changing any
+    // score, found when the input is read
+    vector<int> symmetryClass;  // by worker id
+    vector<int> classSizes;     // by class, classes by their first worker
 
-    void buildWorkersAvailable();
+    // presolve results, empty until presolve is called
+    bool presolved;
+    vector<TimeSlotNode *> forcedSlots;
+    int forcedShifts;
+    int fixedWorkers;  // every slot of theirs is forced
+    int idleSlots;     // in shifts that need nobody
+    int tightWorkers;  // exactly as many slots as their max shifts
 
+    void normalizePriority();
+    pair<Fixed, Fixed> findMinMaxPriority(const vector<Fixed> &priorities);
 
-    void readFiles(string &inputDirectory);
-    void readHeader(ifstream &infile, string &name, int &maxShifts);
-    void readShifts(ifstream &infile, string filename, WorkerNode *currWorker);
-    vector<string> readLikes(ifstream &infile);
+    void copyWorkers(const WorkerInputData &other, const vector<int> &workerIds);
+    void buildWorkersAvailable();
+    void assignIds();
+    void findSymmetryClasses();
+    vector<Fixed> symmetrySignature(int workerId, 
+                                    const vector<vector<int>> &likedBy);
+
+
+    void readInput(string &inputPath);
+    void readFiles(string &inputDirectory, vector<vector<string>> &likes);
+    void readHeader(istream &infile, const string &filename, string &name, 
+                    int &maxShifts);
+    void readShifts(istream &infile, string filename, WorkerNode *currWorker);
+    void readShift(istream &line, const string &filename, 
+                   WorkerNode *currWorker);
+    vector<string> readLikes(istream &infile);
+    void readBulk(istream &input, const string &source,
+                  vector<vector<string>> &likes);
     void processLikes(vector<vector<string>> &likes);
 
-    WorkerNode *findWorker(string name);
+    static int parseMaxShifts(string value, const string &where);
+    static bool readLine(istream &input, string &line);
     int dayStringToInt(string dayName);
     int shiftStringToInt(string shiftName);
     template <typename streamtype>
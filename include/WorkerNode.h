@@ -9,6 +9,7 @@
 #include <unordered_set>
 
 #include "ScheduleData.h"
+#include "ScoreWeights.h"
 #include "TimeSlotNode.h"
 
 using namespace std;
@@ -29,13 +30,17 @@ public:
     const unordered_set<WorkerNode *> &getLikedCoworkers() const;
     const vector<TimeSlotNode *> &getAllocations() const;
     const string getName() const;
+    int getId() const;
+    void setId(int newId);
+    const ScoreWeights &getWeights() const;
+    void setWeights(const ScoreWeights *newWeights);
     int getShiftsRemaining() const;
     int getMaxShifts() const;
     int getRelativeBooking() const;
 
     void updateShiftsRemaining(int updateFactor); // TODO: this should not be public
 
-    void addShift(int day, int shift, double priority);
+    void addShift(int day, int shift, Fixed priority);
     void addLikedCoworker(WorkerNode *newWorker);
 
     void allocateBlock(TimeSlotNode *toChoose); // TODO: remove all "problem"
@@ -49,6 +54,8 @@ private:
 
 
     string name;
+    int id; // index in WorkerInputData's worker list
+    const ScoreWeights *weights; // of the WorkerInputData it belongs to
 
     vector<TimeSlotNode *> timesAvailable;
     vector<TimeSlotNode *> timesAllocated;
@@ -0,0 +1,34 @@
+#include "AllocationCounter.h"
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+
+using namespace std;
+
+static atomic<unsigned long long> allocationCount(0);
+
+unsigned long long AllocationCounter::getCount() {
+    return allocationCount.load(memory_order_relaxed);
+}
+
+// replacing these also covers new[], delete[] and the nothrow versions, which
+// forward to them by default
+void *operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void *memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void *memory, size_t size) noexcept {
+    (void) size;
+    free(memory);
+}
@@ -0,0 +1,161 @@
+#include "ComponentSweep.h"
+
+ComponentSweep::ComponentSweep(WorkerInputData &data, const RunOptions &options,
+                               ThreadPool *newPool)
+    : inputData(data), componentOptions(options) {
+    pool = newPool;
+    secondsTaken = 0;
+
+    // workers without a shift that needs anyone have nothing to schedule,
+    // and a sweep over only them would have no average
+    vector<vector<int>> found = inputData.findComponents();
+    idleWorkers = 0;
+    for (size_t i = 0; i < found.size(); i++) {
+        if (hasWork(found[i])) {
+            components.push_back(found[i]);
+        } else {
+            idleWorkers += found[i].size();
+        }
+    }
+    if (components.empty()) {
+        throw runtime_error("Error: no shift needs any of the workers");
+    }
+
+    // --threads sweeps that many components at once instead of splitting
+    // the seeds of one
+    numThreads = min(options.threads, (int) components.size());
+    componentOptions.threads = 1;
+
+    for (size_t i = 0; i < components.size(); i++) {
+        componentData.emplace_back(new WorkerInputData(inputData, components[i]));
+        sweeps.emplace_back(new SeedSweep(*componentData[i], componentOptions,
+                                          pool));
+        sweeps[i]->setLabel("Component " + to_string(i + 1) + ": ");
+    }
+}
+
+bool ComponentSweep::hasWork(const vector<int> &workerIds) {
+    for (size_t i = 0; i < workerIds.size(); i++) {
+        const vector<TimeSlotNode *> &available = 
+            inputData.getWorker(workerIds[i])->getAvailability();
+        for (size_t j = 0; j < available.size(); j++) {
+            int day = available[j]->getDay(), shift = available[j]->getShift();
+            if (inputData.getWorkersPerShift(day, shift) > 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int ComponentSweep::getNumComponents() const {
+    return components.size();
+}
+
+// every component sweeps the same seeds, fewer if one was interrupted
+unsigned int ComponentSweep::getSeedsChecked() const {
+    unsigned int seedsChecked = sweeps.front()->getSeedsChecked();
+    for (size_t i = 1; i < sweeps.size(); i++) {
+        seedsChecked = min(seedsChecked, sweeps[i]->getSeedsChecked());
+    }
+    return seedsChecked;
+}
+
+// the largest components start first, so that a thread is not left with a
+// large one at the end
+void ComponentSweep::run(const atomic<bool> &keepGoing) {
+    auto t1 = chrono::high_resolution_clock::now();
+
+    vector<int> order(components.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(), [this](int c1, int c2) {
+        return components[c1].size() > components[c2].size();
+    });
+
+    auto sweep = [&](int index, int thread) {
+        (void) thread;
+        sweeps[order[index]]->run(keepGoing);
+    };
+    if (numThreads == 1) {
+        for (size_t i = 0; i < order.size(); i++) {
+            sweep(i, 0);
+        }
+    } else {
+        ThreadPool componentPool(numThreads);
+        componentPool.parallelFor(order.size(), sweep);
+    }
+
+    auto t2 = chrono::high_resolution_clock::now();
+    auto ms_int = chrono::duration_cast<chrono::milliseconds>(t2 - t1);
+    secondsTaken = (double) ms_int.count() / 1000;
+}
+
+// runs the best seed of every component again, or loads the schedule path
+// relinking found, and loads the union of them into scheduler, which has to
+// be on the whole input
+void ComponentSweep::combine(Scheduler &scheduler) {
+    vector<TimeSlotNode *> slots;
+    for (size_t i = 0; i < components.size(); i++) {
+        const EliteSchedule *relinked = sweeps[i]->getRelinkedBest();
+        unsigned int seed = relinked ? relinked->seed : sweeps[i]->getBestSeed();
+        Scheduler part(*componentData[i], seed);
+        SeedSweep::configureScheduler(part, componentOptions, pool);
+        part.setPerturbation(relinked ? relinked->perturbation 
+                                      : sweeps[i]->getBestPerturbation());
+        if (relinked != nullptr) {
+            const vector<TimeSlotNode *> &slotList = componentData[i]->getSlotList();
+            vector<TimeSlotNode *> partSlots;
+            for (size_t j = 0; j < relinked->slotIds.size(); j++) {
+                partSlots.push_back(slotList[relinked->slotIds[j]]);
+            }
+            part.loadSchedule(partSlots);
+        } else {
+            part.calculate();
+        }
+
+        // a copied worker has the same availability, in the same order
+        for (size_t j = 0; j < components[i].size(); j++) {
+            WorkerNode *copy = componentData[i]->getWorker(j);
+            WorkerNode *original = inputData.getWorker(components[i][j]);
+            const vector<TimeSlotNode *> &allocations = copy->getAllocations();
+            if (allocations.empty()) {
+                continue;
+            }
+            int firstId = copy->getAvailability().front()->getId();
+            for (size_t k = 0; k < allocations.size(); k++) {
+                int index = allocations[k]->getId() - firstId;
+                slots.push_back(original->getAvailability()[index]);
+            }
+        }
+    }
+    scheduler.loadSchedule(slots);
+}
+
+void ComponentSweep::printComponents(ostream &output) const {
+    output << "Components: " << components.size();
+    if (idleWorkers > 0) {
+        output << ", plus " << idleWorkers << " workers no shift needs";
+    }
+    output << endl;
+    for (size_t i = 0; i < components.size(); i++) {
+        output << "    " << i + 1 << ": " << components[i].size()
+               << " workers, best seed " << sweeps[i]->getBestSeed()
+               << ", score " << sweeps[i]->getBestScore() << endl;
+    }
+}
+
+void ComponentSweep::printProfile(ostream &output) const {
+    output << "Time taken (s): " << secondsTaken << endl;
+    output << "Components swept at once: " << numThreads << endl;
+    if (numThreads > 1) {
+        output << "(heap allocations below are of all components together)" 
+               << endl;
+    }
+    for (size_t i = 0; i < components.size(); i++) {
+        output << "Component " << i + 1 << ", " << components[i].size()
+               << " workers:" << endl;
+        sweeps[i]->printProfile(output);
+    }
+}
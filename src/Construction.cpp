@@ -0,0 +1,19 @@
+#include "Construction.h"
+
+static const string constructionNames[NUM_CONSTRUCTIONS] = {
+    "random", "constrained", "regret", "scarcity"};
+
+string constructionName(Construction construction) {
+    return constructionNames[(int) construction];
+}
+
+// returns false if name is not a construction
+bool parseConstruction(const string &name, Construction &construction) {
+    for (int i = 0; i < NUM_CONSTRUCTIONS; i++) {
+        if (constructionNames[i] == name) {
+            construction = (Construction) i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,41 @@
+#include "CounterRandom.h"
+
+CounterRandom::CounterRandom(uint64_t seed) {
+    setSeed(seed);
+}
+
+void CounterRandom::setSeed(uint64_t seed) {
+    key = mix(seed);
+}
+
+// SplitMix64 finalizer applied to a position in the (stream, counter) plane
+uint64_t CounterRandom::at(uint64_t stream, uint64_t counter) const {
+    return mix(key + stream * 0xD1B54A32D192ED03ULL +
+               counter * 0x9E3779B97F4A7C15ULL);
+}
+
+double CounterRandom::uniformAt(uint64_t stream, uint64_t counter) const {
+    return (at(stream, counter) >> 11) * 0x1.0p-53;
+}
+
+// multiply-shift range reduction, bias is below 2^-32 for any bound
+uint32_t CounterRandom::belowAt(uint64_t stream, uint64_t counter,
+                                uint32_t bound) const {
+    return (uint32_t) (((at(stream, counter) >> 32) * bound) >> 32);
+}
+
+// no loop carried state, so the compiler is free to vectorize this
+void CounterRandom::fillUniform(double *out, size_t n, uint64_t stream) const {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = uniformAt(stream, i);
+    }
+}
+
+uint64_t CounterRandom::mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
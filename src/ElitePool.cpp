@@ -0,0 +1,79 @@
+#include "ElitePool.h"
+
+ElitePool::ElitePool(int newCapacity) {
+    capacity = newCapacity;
+    schedules.reserve(capacity + 1);
+}
+
+bool ElitePool::isEnabled() const {
+    return capacity > 0;
+}
+
+int ElitePool::getCapacity() const {
+    return capacity;
+}
+
+// whether a schedule with this score would make it in, before copying it
+bool ElitePool::accepts(double score, unsigned int seed) const {
+    lock_guard<mutex> guard(lock);
+    return acceptsLocked(score, seed);
+}
+
+bool ElitePool::acceptsLocked(double score, unsigned int seed) const {
+    if (!isEnabled()) {
+        return false;
+    }
+    if ((int) schedules.size() < capacity) {
+        return true;
+    }
+    const EliteSchedule &worst = schedules.back();
+    return better(score, seed, worst.score, worst.seed);
+}
+
+// a schedule with the same hash as one in the pool replaces it if better and
+// is dropped otherwise
+bool ElitePool::offer(const EliteSchedule &schedule) {
+    lock_guard<mutex> guard(lock);
+    if (!acceptsLocked(schedule.score, schedule.seed)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < schedules.size(); i++) {
+        if (schedules[i].hash == schedule.hash) {
+            if (!better(schedule.score, schedule.seed,
+                        schedules[i].score, schedules[i].seed)) {
+                return false;
+            }
+            schedules.erase(schedules.begin() + i);
+            break;
+        }
+    }
+
+    size_t index = 0;
+    while (index < schedules.size() and
+           !better(schedule.score, schedule.seed,
+                   schedules[index].score, schedules[index].seed)) {
+        index++;
+    }
+    schedules.insert(schedules.begin() + index, schedule);
+    if ((int) schedules.size() > capacity) {
+        schedules.pop_back();
+    }
+    return true;
+}
+
+// a copy, since other threads may still be offering
+vector<EliteSchedule> ElitePool::getSchedules() const {
+    lock_guard<mutex> guard(lock);
+    return schedules;
+}
+
+int ElitePool::size() const {
+    lock_guard<mutex> guard(lock);
+    return schedules.size();
+}
+
+bool ElitePool::better(double score1, unsigned int seed1,
+                       double score2, unsigned int seed2) {
+    return score1 > score2 or (score1 == score2 and seed1 < seed2);
+}
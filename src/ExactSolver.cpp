@@ -0,0 +1,685 @@
+#include "ExactSolver.h"
+
+ExactSolver::ExactSolver(WorkerInputData &data, int newThreads)
+    : inputData(data), weights(data.getWeights()), incumbentScore(-numeric_limits<double>::infinity()),
+      stopped(false) {
+    numThreads = newThreads;
+    numWorkers = inputData.getNumWorkers();
+    if (numWorkers > MAX_WORKERS) {
+        throw runtime_error("Error: --exact handles at most " +
+                            to_string(MAX_WORKERS) + " workers, the input has " +
+                            to_string(numWorkers));
+    }
+    // a negative proportion would need a lower bound on its term instead
+    if (weights.getAverageProportion() < 0 or 
+        weights.getLowestProportion() < 0) {
+        throw runtime_error("Error: --exact needs the average and lowest "
+                            "proportions to be non-negative");
+    }
+    incumbentRange = -1;
+    heuristicScore = -1;
+    incumbentsOffered = 0;
+    taskDepth = 0;
+    splitDepth = -1;
+    nodes = 0;
+    tasksDone = 0;
+    secondsTaken = 0;
+
+    for (int i = 0; i < numWorkers; i++) {
+        WorkerNode *worker = inputData.getWorker(i);
+        maxShifts.push_back(worker->getMaxShifts());
+        uint64_t liked = 0;
+        const unordered_set<WorkerNode *> &likedCoworkers = worker->getLikedCoworkers();
+        for (auto it = likedCoworkers.begin(); it != likedCoworkers.end(); it++) {
+            liked |= 1ULL << (*it)->getId();
+        }
+        likes.push_back(liked);
+        int classId = inputData.getSymmetryClass(i);
+        symmetryClass.push_back(inputData.getClassSize(classId) > 1 ? classId : -1);
+    }
+
+    // every shift that needs anyone, with fewer spare candidates first
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            const vector<TimeSlotNode *> &available = inputData.getWorkersAvailable(i, j);
+            int needed = min((size_t) inputData.getWorkersPerShift(i, j),
+                             available.size());
+            if (needed == 0) {
+                continue;
+            }
+            Column column;
+            column.day = i;
+            column.shift = j;
+            column.needed = needed;
+            column.available = 0;
+            for (size_t k = 0; k < available.size(); k++) {
+                column.available |= 1ULL << available[k]->getParent()->getId();
+            }
+            columns.push_back(column);
+        }
+    }
+    stable_sort(columns.begin(), columns.end(),
+                [](const Column &c1, const Column &c2) {
+        return __builtin_popcountll(c1.available) - c1.needed <
+               __builtin_popcountll(c2.available) - c2.needed;
+    });
+
+    int numColumns = columns.size();
+    dayColumns.assign(NUM_DAYS, 0);
+    truePriorities.assign(numWorkers * numColumns, 0);
+    optimisticValues.assign(numWorkers * numColumns, 0);
+    slots.assign(numWorkers * numColumns, nullptr);
+    optimistic.resize(numWorkers);
+    totalShifts = 0;
+    for (int i = 0; i < numColumns; i++) {
+        Column &column = columns[i];
+        dayColumns[column.day] |= 1ULL << i;
+        totalShifts += column.needed;
+
+        // without a penalty, which is never negative, and with every liked
+        // coworker that could share the shift
+        vector<Fixed> values(numWorkers, 0);
+        const vector<TimeSlotNode *> &available =
+            inputData.getWorkersAvailable(column.day, column.shift);
+        for (size_t j = 0; j < available.size(); j++) {
+            int worker = available[j]->getParent()->getId();
+            uint64_t self = 1ULL << worker;
+            int liked = __builtin_popcountll(likes[worker] & column.available & ~self);
+            liked = min(liked, column.needed - 1);
+            if (likes[worker] & self) {
+                liked++;  // the worker counts themselves
+            }
+            values[worker] = available[j]->getTruePriority() +
+                             weights.bonusFor(liked);
+            truePriorities[worker * numColumns + i] = available[j]->getTruePriority();
+            optimisticValues[worker * numColumns + i] = values[worker];
+            slots[worker * numColumns + i] = available[j];
+            optimistic[worker].push_back({values[worker], i});
+            column.candidates.push_back(worker);
+        }
+        stable_sort(column.candidates.begin(), column.candidates.end(),
+                    [&values](int w1, int w2) {
+            return values[w1] > values[w2] or
+                   (values[w1] == values[w2] and w1 < w2);
+        });
+
+        column.earlierTwins.resize(column.candidates.size());
+        for (size_t j = 0; j < column.candidates.size(); j++) {
+            int classId = symmetryClass[column.candidates[j]];
+            for (size_t k = 0; classId >= 0 and k < j; k++) {
+                if (symmetryClass[column.candidates[k]] == classId) {
+                    column.earlierTwins[j].push_back(k);
+                }
+            }
+        }
+    }
+    for (int i = 0; i < numWorkers; i++) {
+        stable_sort(optimistic[i].begin(), optimistic[i].end(),
+                    [](const Optimistic &o1, const Optimistic &o2) {
+            return o1.value > o2.value;
+        });
+    }
+    bestMembers.assign(numColumns, 0);
+    findMinPenalties();
+}
+
+// the least penalty of k shifts on one day, over every k of the worker's
+// shifts that day, then the least over every way to split a number of
+// shifts between the days
+void ExactSolver::findMinPenalties() {
+    const Fixed unreachable = numeric_limits<Fixed>::max();
+    minPenalty.resize(numWorkers);
+    for (int i = 0; i < numWorkers; i++) {
+        vector<Fixed> best(1, 0);  // by shifts so far
+        for (int day = 0; day < NUM_DAYS; day++) {
+            vector<int> shifts;
+            for (uint64_t left = dayColumns[day]; left; left &= left - 1) {
+                int column = __builtin_ctzll(left);
+                if ((columns[column].available >> i) & 1) {
+                    shifts.push_back(columns[column].shift);
+                }
+            }
+
+            int numShifts = shifts.size();
+            vector<Fixed> dayBest(numShifts + 1, unreachable);
+            for (int subset = 0; subset < (1 << numShifts); subset++) {
+                Fixed penalty = 0;
+                for (int j = 0; j < numShifts; j++) {
+                    if (!((subset >> j) & 1)) {
+                        continue;
+                    }
+                    int doubleDay = 0, doubleShift = 0;
+                    for (int k = 0; k < numShifts; k++) {
+                        if (k == j or !((subset >> k) & 1)) {
+                            continue;
+                        }
+                        if (shifts[k] == shifts[j] - 1 or shifts[k] == shifts[j] + 1) {
+                            doubleShift++;
+                        } else {
+                            doubleDay++;
+                        }
+                    }
+                    penalty += weights.penaltyFor(doubleDay, doubleShift);
+                }
+                int size = __builtin_popcount(subset);
+                dayBest[size] = min(dayBest[size], penalty);
+            }
+
+            vector<Fixed> next(best.size() + numShifts, unreachable);
+            for (size_t j = 0; j < best.size(); j++) {
+                for (int k = 0; k <= numShifts; k++) {
+                    next[j + k] = min(next[j + k], best[j] + dayBest[k]);
+                }
+            }
+            best = next;
+        }
+        minPenalty[i] = best;
+    }
+}
+
+/******************************* Incumbent ********************************/
+
+// keeps the most balanced schedule offered, then the best scoring. A
+// schedule that leaves a shift short is not one the search can reach
+void ExactSolver::offerIncumbent(const Scheduler &scheduler) {
+    const vector<vector<vector<TimeSlotNode *>>> &schedule =
+        scheduler.getFinalSchedule();
+    SearchState state;
+    initState(state);
+    for (size_t i = 0; i < columns.size(); i++) {
+        const vector<TimeSlotNode *> &workers =
+            schedule[columns[i].day][columns[i].shift];
+        uint64_t chosen = 0;
+        for (size_t j = 0; j < workers.size(); j++) {
+            chosen |= 1ULL << workers[j]->getParent()->getId();
+        }
+        if (__builtin_popcountll(chosen) != columns[i].needed) {
+            return;
+        }
+        apply(state, i, chosen);
+    }
+    incumbentsOffered++;
+
+    int range;
+    double value = score(state, range);
+    if (incumbentRange < 0 or range < incumbentRange or
+        (range == incumbentRange and value > incumbentScore)) {
+        incumbentRange = range;
+        incumbentScore = value;
+        heuristicScore = value;
+        bestMembers = state.members;
+    }
+}
+
+void ExactSolver::offerLeaf(const SearchState &state) {
+    int range;
+    double value = score(state, range);
+    if (range > incumbentRange or value <= incumbentScore) {
+        return;
+    }
+    lock_guard<mutex> guard(bestLock);
+    if (value > incumbentScore) {
+        incumbentScore = value;
+        bestMembers = state.members;
+    }
+}
+
+/********************************* Search *********************************/
+
+// splits the top of the tree into tasks, the best bound first, and
+// searches them on every thread. Ctrl-C stops the search with the best
+// schedule found so far
+void ExactSolver::run(const atomic<bool> &keepGoing) {
+    if (incumbentRange < 0) {
+        throw runtime_error("Error: no heuristic schedule to start the exact "
+                            "search from");
+    }
+    auto t1 = chrono::high_resolution_clock::now();
+
+    SearchState planning;
+    initState(planning);
+    size_t wanted = TASKS_PER_THREAD * numThreads;
+    for (splitDepth = 0; splitDepth < (int) columns.size(); splitDepth++) {
+        tasks.clear();
+        search(planning, 0, keepGoing);
+        if (tasks.size() >= wanted or splitDepth + 1 == (int) columns.size()) {
+            break;
+        }
+    }
+    taskDepth = splitDepth;
+    splitDepth = -1;
+    nodes = planning.nodes;
+    stable_sort(tasks.begin(), tasks.end(), [](const Task &task1, const Task &task2) {
+        return task1.bound > task2.bound;
+    });
+
+    vector<SearchState> states(numThreads);
+    for (int i = 0; i < numThreads; i++) {
+        initState(states[i]);
+    }
+    auto work = [&](int index, int thread) {
+        runTask(tasks[index], states[thread], keepGoing);
+    };
+    if (numThreads == 1) {
+        for (size_t i = 0; i < tasks.size(); i++) {
+            work(i, 0);
+        }
+    } else {
+        ThreadPool taskPool(numThreads);
+        taskPool.parallelFor(tasks.size(), work);
+    }
+
+    for (int i = 0; i < numThreads; i++) {
+        nodes += states[i].nodes;
+    }
+    for (size_t i = 0; i < tasks.size(); i++) {
+        tasksDone += tasks[i].done;
+    }
+
+    auto t2 = chrono::high_resolution_clock::now();
+    auto ms_int = chrono::duration_cast<chrono::milliseconds>(t2 - t1);
+    secondsTaken = (double) ms_int.count() / 1000;
+}
+
+void ExactSolver::runTask(Task &task, SearchState &state,
+                          const atomic<bool> &keepGoing) {
+    int depth = task.prefix.size();
+    for (int i = 0; i < depth; i++) {
+        apply(state, i, task.prefix[i]);
+    }
+    if (task.bound > incumbentScore) {
+        search(state, depth, keepGoing);
+    }
+    for (int i = depth - 1; i >= 0; i--) {
+        undo(state, i, task.prefix[i]);
+    }
+    task.done = !stopped;
+}
+
+// columns before depth are filled
+void ExactSolver::search(SearchState &state, int depth,
+                         const atomic<bool> &keepGoing) {
+    state.nodes++;
+    if (!keepGoing) {
+        stopped = true;
+        return;
+    }
+    if (depth == (int) columns.size()) {
+        offerLeaf(state);
+        return;
+    }
+    double nodeBound = bound(state, depth);
+    if (nodeBound <= incumbentScore) {
+        return;
+    }
+    if (depth == splitDepth) {
+        Task task;
+        task.prefix.assign(state.members.begin(), state.members.begin() + depth);
+        task.bound = nodeBound;
+        tasks.push_back(task);
+        return;
+    }
+    chooseWorkers(state, depth, 0, columns[depth].needed, 0, keepGoing);
+}
+
+// takes or skips each candidate of the column in turn. A candidate is not
+// taken after skipping an interchangeable one with the same shifts so far,
+// which would only give the same schedules with the two swapped
+void ExactSolver::chooseWorkers(SearchState &state, int depth, size_t next,
+                                int needed, uint64_t chosen,
+                                const atomic<bool> &keepGoing) {
+    const Column &column = columns[depth];
+    if (needed == 0) {
+        apply(state, depth, chosen);
+        search(state, depth + 1, keepGoing);
+        undo(state, depth, chosen);
+        return;
+    }
+    if ((int) (column.candidates.size() - next) < needed or stopped) {
+        return;
+    }
+
+    int worker = column.candidates[next];
+    bool twinSkipped = false;
+    const vector<int> &earlierTwins = column.earlierTwins[next];
+    for (size_t i = 0; i < earlierTwins.size() and !twinSkipped; i++) {
+        int twin = column.candidates[earlierTwins[i]];
+        twinSkipped = !((chosen >> twin) & 1) and
+                      state.assigned[twin] == state.assigned[worker];
+    }
+    if (!twinSkipped) {
+        chooseWorkers(state, depth, next + 1, needed - 1,
+                      chosen | (1ULL << worker), keepGoing);
+    }
+    chooseWorkers(state, depth, next + 1, needed, chosen, keepGoing);
+}
+
+/****************************** Search State ******************************/
+
+void ExactSolver::initState(SearchState &state) const {
+    state.assigned.assign(numWorkers, 0);
+    state.counts.assign(numWorkers, 0);
+    state.remaining.assign(numWorkers, 0);
+    for (size_t i = 0; i < columns.size(); i++) {
+        for (uint64_t left = columns[i].available; left; left &= left - 1) {
+            state.remaining[__builtin_ctzll(left)]++;
+        }
+    }
+    state.daySums.assign(numWorkers * NUM_DAYS, 0);
+    state.workerSums.assign(numWorkers, 0);
+    state.dayGross.assign(numWorkers * NUM_DAYS, 0);
+    state.workerGross.assign(numWorkers, 0);
+    state.total = 0;
+    state.members.assign(columns.size(), 0);
+    state.nodes = 0;
+}
+
+// fills the column at depth with the chosen workers
+void ExactSolver::apply(SearchState &state, int depth, uint64_t chosen) const {
+    const Column &column = columns[depth];
+    state.members[depth] = chosen;
+    for (uint64_t left = column.available; left; left &= left - 1) {
+        state.remaining[__builtin_ctzll(left)]--;
+    }
+    for (uint64_t left = chosen; left; left &= left - 1) {
+        int worker = __builtin_ctzll(left);
+        state.assigned[worker] |= 1ULL << depth;
+        state.counts[worker]++;
+    }
+    for (uint64_t left = chosen; left; left &= left - 1) {
+        updateDay(state, __builtin_ctzll(left), column.day);
+    }
+}
+
+void ExactSolver::undo(SearchState &state, int depth, uint64_t chosen) const {
+    const Column &column = columns[depth];
+    state.members[depth] = 0;
+    for (uint64_t left = column.available; left; left &= left - 1) {
+        state.remaining[__builtin_ctzll(left)]++;
+    }
+    for (uint64_t left = chosen; left; left &= left - 1) {
+        int worker = __builtin_ctzll(left);
+        state.assigned[worker] &= ~(1ULL << depth);
+        state.counts[worker]--;
+    }
+    for (uint64_t left = chosen; left; left &= left - 1) {
+        updateDay(state, __builtin_ctzll(left), column.day);
+    }
+}
+
+// the priorities of a worker's shifts on one day as TimeSlotNode::getPriority
+// gives them, with the penalties between those shifts and the bonuses of
+// their filled columns
+void ExactSolver::updateDay(SearchState &state, int worker, int day) const {
+    int numColumns = columns.size();
+    uint64_t onDay = state.assigned[worker] & dayColumns[day];
+    Fixed sum = 0, gross = 0;
+    for (uint64_t left = onDay; left; left &= left - 1) {
+        int column = __builtin_ctzll(left);
+        int shift = columns[column].shift;
+        int doubleDay = 0, doubleShift = 0;
+        for (uint64_t others = onDay & ~(1ULL << column); others;
+             others &= others - 1) {
+            int other = columns[__builtin_ctzll(others)].shift;
+            if (other == shift - 1 or other == shift + 1) {
+                doubleShift++;
+            } else {
+                doubleDay++;
+            }
+        }
+        int liked = __builtin_popcountll(likes[worker] & state.members[column]);
+        Fixed value = truePriorities[worker * numColumns + column] +
+                      weights.bonusFor(liked);
+        gross += value;
+        sum += value - weights.penaltyFor(doubleDay, doubleShift);
+    }
+
+    Fixed &daySum = state.daySums[worker * NUM_DAYS + day];
+    state.workerSums[worker] += sum - daySum;
+    state.total += sum - daySum;
+    daySum = sum;
+    Fixed &dayGross = state.dayGross[worker * NUM_DAYS + day];
+    state.workerGross[worker] += gross - dayGross;
+    dayGross = gross;
+}
+
+/********************************* Bounds *********************************/
+
+// bookings only grow, so the final most booked worker is at least the most
+// booked now, and the least booked at most the least that can still be.
+// False if that already makes the range more than the incumbent's
+bool ExactSolver::bookingRange(const SearchState &state, int &maxBooking,
+                               int &minBooking) const {
+    maxBooking = INT_MIN;
+    minBooking = INT_MAX;
+    for (int i = 0; i < numWorkers; i++) {
+        int booking = state.counts[i] - maxShifts[i];
+        maxBooking = max(maxBooking, booking);
+        minBooking = min(minBooking, booking + state.remaining[i]);
+    }
+    return maxBooking - minBooking <= incumbentRange;
+}
+
+// no schedule below the node scores more, -infinity if none of them is as
+// balanced as the incumbent
+double ExactSolver::bound(const SearchState &state, int depth) const {
+    const double none = -numeric_limits<double>::infinity();
+    int maxBooking, minBooking;
+    if (!bookingRange(state, maxBooking, minBooking)) {
+        return none;
+    }
+
+    // the best average each worker can end with, over the number of shifts
+    // that keeps the range. Workers that can end without shifts do not count
+    // towards the lowest, but the lowest is at most the best of anyone's.
+    // The best total of each worker on their own bounds the total too
+    double lowest = numeric_limits<double>::infinity();
+    double highest = none;
+    Fixed workersTotal = 0;
+    bool full[MAX_WORKERS];  // can take no more shifts
+    for (int i = 0; i < numWorkers; i++) {
+        int low = max(state.counts[i], maxShifts[i] + maxBooking - incumbentRange);
+        int high = min(state.counts[i] + state.remaining[i],
+                       maxShifts[i] + minBooking + incumbentRange);
+        if (low > high) {
+            return none;
+        }
+        full[i] = state.counts[i] == high;
+
+        // the shifts still to come pay at least the penalties between the
+        // ones so far, and all of them at least the least any choice pays
+        Fixed added = 0;
+        int count = state.counts[i];
+        double best = none;
+        Fixed bestSum = numeric_limits<Fixed>::min();
+        const vector<Optimistic> &values = optimistic[i];
+        size_t next = 0;
+        while (true) {
+            if (count >= low) {
+                Fixed sum = min(state.workerSums[i] + added,
+                                state.workerGross[i] + added - minPenalty[i][count]);
+                bestSum = max(bestSum, sum);
+                if (count > 0) {
+                    best = max(best, fromFixed(sum) / count);
+                }
+            }
+            if (count == high) {
+                break;
+            }
+            while (values[next].column < depth) {
+                next++;
+            }
+            added += values[next++].value;
+            count++;
+        }
+        highest = max(highest, best);
+        if (low >= 1) {
+            lowest = min(lowest, best);
+        }
+        workersTotal += bestSum;
+    }
+    lowest = min(lowest, highest);
+
+    // every column left gets its best group of candidates that can still
+    // take a shift, each with the penalty of their shifts already on that
+    // day. Groups are tried one by one while there are few
+    Fixed columnsTotal = state.total;
+    int numColumns = columns.size();
+    for (int i = depth; i < numColumns; i++) {
+        const Column &column = columns[i];
+        GroupBound group;
+        group.needed = column.needed;
+        group.numCandidates = 0;
+        for (size_t j = 0; j < column.candidates.size(); j++) {
+            int worker = column.candidates[j];
+            if (full[worker]) {
+                continue;
+            }
+            Fixed penalty = 0;
+            uint64_t onDay = state.assigned[worker] & dayColumns[column.day];
+            if (onDay != 0) {
+                int doubleDay = 0, doubleShift = 0;
+                for (; onDay; onDay &= onDay - 1) {
+                    int other = columns[__builtin_ctzll(onDay)].shift;
+                    if (other == column.shift - 1 or other == column.shift + 1) {
+                        doubleShift++;
+                    } else {
+                        doubleDay++;
+                    }
+                }
+                penalty = weights.penaltyFor(doubleDay, doubleShift);
+            }
+            int n = group.numCandidates++;
+            group.workers[n] = worker;
+            group.base[n] = truePriorities[worker * numColumns + i] - penalty;
+            group.optimistic[n] = optimisticValues[worker * numColumns + i] - penalty;
+        }
+        if (group.numCandidates < column.needed) {
+            return none;  // too few candidates left to fill it
+        }
+        columnsTotal += bestGroup(group);
+    }
+
+    double average = fromFixed(min(columnsTotal, workersTotal)) / totalShifts;
+    return weights.getAverageProportion() * average 
+           + weights.getLowestProportion() * lowest
+           + max(0.0, weights.getRangeProportion() * incumbentRange);
+}
+
+// the most the candidates of a column can add up to. With few enough groups
+// every one is tried with the bonuses inside it counted exactly, otherwise
+// the best optimistic values are added up
+Fixed ExactSolver::bestGroup(GroupBound &group) const {
+    int n = group.numCandidates;
+    double groups = 1;
+    for (int i = 0; i < group.needed; i++) {
+        groups = groups * (n - i) / (i + 1);
+    }
+
+    if (groups > MAX_GROUPS) {
+        partial_sort(group.optimistic, group.optimistic + group.needed,
+                     group.optimistic + n, greater<Fixed>());
+        Fixed total = 0;
+        for (int i = 0; i < group.needed; i++) {
+            total += group.optimistic[i];
+        }
+        return total;
+    }
+
+    group.best = numeric_limits<Fixed>::min();
+    searchGroups(group, 0, 0, 0, 0);
+    return group.best;
+}
+
+// tries every way to add the rest of the group from candidates >= start
+void ExactSolver::searchGroups(GroupBound &group, int start, int taken,
+                               uint64_t members, Fixed base) const {
+    if (taken == group.needed) {
+        Fixed total = base;
+        for (uint64_t left = members; left; left &= left - 1) {
+            int worker = __builtin_ctzll(left);
+            total += weights.bonusFor(__builtin_popcountll(likes[worker] & members));
+        }
+        group.best = max(group.best, total);
+        return;
+    }
+    for (int i = start; i <= group.numCandidates - (group.needed - taken); i++) {
+        searchGroups(group, i + 1, taken + 1, members | (1ULL << group.workers[i]),
+                     base + group.base[i]);
+    }
+}
+
+// of a complete schedule, as Scheduler::getScore gives it with the range
+// over every worker
+double ExactSolver::score(const SearchState &state, int &range) const {
+    int maxBooking = INT_MIN, minBooking = INT_MAX;
+    double lowest = 0;
+    bool firstWorker = true;
+    for (int i = 0; i < numWorkers; i++) {
+        int booking = state.counts[i] - maxShifts[i];
+        maxBooking = max(maxBooking, booking);
+        minBooking = min(minBooking, booking);
+        if (state.counts[i] == 0) {
+            continue;
+        }
+        double average = fromFixed(state.workerSums[i]) / state.counts[i];
+        if (firstWorker or average < lowest) {
+            lowest = average;
+        }
+        firstWorker = false;
+    }
+    range = maxBooking - minBooking;
+
+    double average = fromFixed(state.total) / totalShifts;
+    return (weights.getAverageProportion() * average) 
+           + (weights.getLowestProportion() * lowest)
+           + (weights.getRangeProportion() * range);
+}
+
+/******************************** Results *********************************/
+
+// the best schedule found, the incumbent if nothing beat it
+void ExactSolver::load(Scheduler &scheduler) const {
+    int numColumns = columns.size();
+    vector<TimeSlotNode *> chosen;
+    for (int i = 0; i < numColumns; i++) {
+        for (uint64_t left = bestMembers[i]; left; left &= left - 1) {
+            chosen.push_back(slots[__builtin_ctzll(left) * numColumns + i]);
+        }
+    }
+    scheduler.loadSchedule(chosen);
+}
+
+// whether the whole tree was searched
+bool ExactSolver::isOptimal() const {
+    return !stopped;
+}
+
+double ExactSolver::getBestScore() const {
+    return incumbentScore;
+}
+
+void ExactSolver::printStats(ostream &output) const {
+    output << "Exact search: " << (isOptimal() ? "optimal" : "stopped")
+           << " among schedules with range <= " << incumbentRange << endl;
+    output << "Heuristic start: " << heuristicScore << " (best of "
+           << incumbentsOffered << " schedules)" << endl;
+    output << "Best score: " << incumbentScore << ", heuristic is "
+           << incumbentScore - heuristicScore << " below" << endl;
+    if (!isOptimal()) {
+        // the subtrees not searched to the end can still hold better
+        double upper = incumbentScore;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            if (!tasks[i].done) {
+                upper = max(upper, tasks[i].bound);
+            }
+        }
+        output << "Upper bound: " << upper << ", gap "
+               << upper - incumbentScore << endl;
+    }
+    output << "Nodes: " << nodes << ", tasks: " << tasksDone << " of "
+           << tasks.size() << " searched, split after " << taskDepth
+           << " shifts" << endl;
+    output << "Time taken (s): " << secondsTaken << ", threads: " << numThreads
+           << endl;
+}
@@ -0,0 +1,110 @@
+#include "IndexedHeap.h"
+
+IndexedHeap::IndexedHeap() {
+}
+
+// ids pushed afterwards must be in [0, numIds)
+void IndexedHeap::resize(int numIds) {
+    clear();
+    position.assign(numIds, -1);
+    heap.reserve(numIds);
+}
+
+// O(number of ids in the heap), not O(numIds)
+void IndexedHeap::clear() {
+    for (size_t i = 0; i < heap.size(); i++) {
+        position[heap[i].id] = -1;
+    }
+    heap.clear();
+}
+
+bool IndexedHeap::empty() const {
+    return heap.empty();
+}
+
+bool IndexedHeap::contains(int id) const {
+    return position[id] != -1;
+}
+
+// id must be in the heap
+Fixed IndexedHeap::getKey(int id) const {
+    return heap[position[id]].key;
+}
+
+// id must not already be in the heap
+void IndexedHeap::push(int id, Fixed key) {
+    heap.push_back({key, id});
+    position[id] = heap.size() - 1;
+    siftUp(heap.size() - 1);
+}
+
+// id must be in the heap, and key must be at least its current key
+void IndexedHeap::increaseKey(int id, Fixed key) {
+    int index = position[id];
+    heap[index].key = key;
+    siftUp(index);
+}
+
+pair<Fixed, int> IndexedHeap::pop() {
+    Entry top = heap[0];
+    Entry last = heap.back();
+    heap.pop_back();
+    position[top.id] = -1;
+
+    if (not heap.empty()) {
+        place(0, last);
+        siftDown(0);
+    }
+    return {top.key, top.id};
+}
+
+/****************************** Heap Maintenance ******************************/
+
+// whether first should come out of the heap before second
+bool IndexedHeap::higher(const Entry &first, const Entry &second) {
+    return first.key > second.key or
+           (first.key == second.key and first.id < second.id);
+}
+
+void IndexedHeap::siftUp(int index) {
+    Entry entry = heap[index];
+    while (index > 0) {
+        int parent = (index - 1) / ARITY;
+        if (not higher(entry, heap[parent])) {
+            break;
+        }
+        place(index, heap[parent]);
+        index = parent;
+    }
+    place(index, entry);
+}
+
+void IndexedHeap::siftDown(int index) {
+    Entry entry = heap[index];
+    int size = heap.size();
+    while (true) {
+        int firstChild = index * ARITY + 1;
+        if (firstChild >= size) {
+            break;
+        }
+
+        int best = firstChild;
+        int lastChild = min(firstChild + ARITY, size);
+        for (int child = firstChild + 1; child < lastChild; child++) {
+            if (higher(heap[child], heap[best])) {
+                best = child;
+            }
+        }
+        if (not higher(heap[best], entry)) {
+            break;
+        }
+        place(index, heap[best]);
+        index = best;
+    }
+    place(index, entry);
+}
+
+void IndexedHeap::place(int index, const Entry &entry) {
+    heap[index] = entry;
+    position[entry.id] = index;
+}
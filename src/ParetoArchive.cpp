@@ -0,0 +1,120 @@
+#include "ParetoArchive.h"
+
+ParetoArchive::ParetoArchive(bool newEnabled, bool newLargerRangeBetter) {
+    enabled = newEnabled;
+    largerRangeBetter = newLargerRangeBetter;
+    offered = 0;
+    numPoints = 0;
+}
+
+bool ParetoArchive::isEnabled() const {
+    return enabled;
+}
+
+bool ParetoArchive::offer(const ParetoPoint &point) {
+    lock_guard<mutex> guard(lock);
+    offered++;
+
+    // the same point again, from another seed
+    auto front = fronts.find(rangeKey(point.range));
+    if (front != fronts.end()) {
+        auto same = front->second.find(point.average);
+        if (same != front->second.end() and
+            same->second.lowest == point.lowest) {
+            if (point.seed >= same->second.seed) {
+                return false;
+            }
+            same->second = point;
+            return true;
+        }
+    }
+
+    if (dominatedLocked(point)) {
+        return false;
+    }
+    removeDominatedLocked(point);
+    fronts[rangeKey(point.range)][point.average] = point;
+    numPoints++;
+    return true;
+}
+
+// the largest lowest among the points with at least the average is the one
+// with the least such average
+bool ParetoArchive::dominatedLocked(const ParetoPoint &point) const {
+    auto last = fronts.upper_bound(rangeKey(point.range));
+    for (auto front = fronts.begin(); front != last; front++) {
+        auto above = front->second.lower_bound(point.average);
+        if (above != front->second.end() and
+            above->second.lowest >= point.lowest) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// the points with at most the average and the lowest are the ones just below
+// the average, until the lowest gets larger
+void ParetoArchive::removeDominatedLocked(const ParetoPoint &point) {
+    auto front = fronts.lower_bound(rangeKey(point.range));
+    while (front != fronts.end()) {
+        Staircase &staircase = front->second;
+        auto end = staircase.upper_bound(point.average);
+        auto begin = end;
+        while (begin != staircase.begin() and
+               prev(begin)->second.lowest <= point.lowest) {
+            begin--;
+        }
+        numPoints -= distance(begin, end);
+        staircase.erase(begin, end);
+        if (staircase.empty()) {
+            front = fronts.erase(front);
+        } else {
+            front++;
+        }
+    }
+}
+
+int ParetoArchive::rangeKey(int range) const {
+    return largerRangeBetter ? -range : range;
+}
+
+vector<ParetoPoint> ParetoArchive::getFront() const {
+    lock_guard<mutex> guard(lock);
+    vector<ParetoPoint> points;
+    for (auto front = fronts.begin(); front != fronts.end(); front++) {
+        for (auto it = front->second.rbegin(); it != front->second.rend(); it++) {
+            points.push_back(it->second);
+        }
+    }
+    return points;
+}
+
+int ParetoArchive::size() const {
+    lock_guard<mutex> guard(lock);
+    return numPoints;
+}
+
+unsigned long long ParetoArchive::getOffered() const {
+    lock_guard<mutex> guard(lock);
+    return offered;
+}
+
+// tab separated, one line per point, with enough digits to compare exactly.
+// --seed with the construction and noise runs a point again
+void ParetoArchive::write(const string &fileName) const {
+    ofstream output(fileName);
+    if (!output) {
+        throw runtime_error("Error: cannot write " + fileName);
+    }
+    output << "seed\tconstruction\tnoise\taverage\tlowest\trange\tscore"
+           << endl;
+    vector<ParetoPoint> points = getFront();
+    for (size_t i = 0; i < points.size(); i++) {
+        const ParetoPoint &point = points[i];
+        output << point.seed << '\t'
+               << constructionName(point.perturbation.construction) << '\t'
+               << setprecision(6) << 1 / point.perturbation.noiseDivisor 
+               << setprecision(17) << '\t' << point.average << '\t' 
+               << point.lowest << '\t' << point.range << '\t' << point.score << '\n';
+    }
+}
@@ -0,0 +1,113 @@
+#include "PerturbationBandit.h"
+
+#include <math.h>
+
+// from tie breaking only up to noise that reorders close priorities. Given
+// as --noise would be, so that a logged seed can be run again with it
+const double PerturbationBandit::NOISE_LEVELS[NUM_NOISE_LEVELS] = {
+    1e-6, 1e-3, 0.01, 0.03, 0.1};
+
+PerturbationBandit::PerturbationBandit() {
+    for (int i = 0; i < NUM_CONSTRUCTIONS; i++) {
+        for (int j = 0; j < NUM_NOISE_LEVELS; j++) {
+            Perturbation arm;
+            arm.construction = (Construction) i;
+            arm.noiseDivisor = 1 / NOISE_LEVELS[j];
+            arms.push_back(arm);
+        }
+    }
+    stats.resize(arms.size());
+    totalWeight = 0;
+    recentScores.reserve(WINDOW);
+    nextRecent = 0;
+}
+
+// every arm is tried once in order, then the one with the highest upper
+// confidence bound on its reward
+int PerturbationBandit::choose() {
+    lock_guard<mutex> guard(lock);
+    int best = 0;
+    double bestIndex = -1;
+    for (size_t i = 0; i < arms.size(); i++) {
+        const ArmStats &arm = stats[i];
+        if (arm.seeds == 0) {
+            best = i;
+            break;
+        }
+        if (arm.weight <= 0) {  // handed out, but not rewarded yet
+            continue;
+        }
+        double index = arm.rewardSum / arm.weight + 
+                       sqrt(2 * log(max(totalWeight, 1.0)) / arm.weight);
+        if (index > bestIndex) {
+            bestIndex = index;
+            best = i;
+        }
+    }
+    stats[best].seeds++;
+    return best;
+}
+
+const Perturbation &PerturbationBandit::getArm(int arm) const {
+    return arms[arm];
+}
+
+void PerturbationBandit::reward(int arm, double score) {
+    lock_guard<mutex> guard(lock);
+    double value = 0;
+    if (score >= 0) {
+        value = rank(score);
+        if ((int) recentScores.size() < WINDOW) {
+            recentScores.push_back(score);
+        } else {
+            recentScores[nextRecent] = score;
+            nextRecent = (nextRecent + 1) % WINDOW;
+        }
+    }
+
+    for (size_t i = 0; i < stats.size(); i++) {
+        stats[i].weight *= DISCOUNT;
+        stats[i].rewardSum *= DISCOUNT;
+    }
+    totalWeight = totalWeight * DISCOUNT + 1;
+
+    ArmStats &stat = stats[arm];
+    stat.weight += 1;
+    stat.rewardSum += value;
+    stat.totalReward += value;
+    stat.bestScore = max(stat.bestScore, score);
+}
+
+// share of the recent scores below score, ties count half. The first score
+// has nothing to beat and gets the middle
+double PerturbationBandit::rank(double score) const {
+    if (recentScores.empty()) {
+        return 0.5;
+    }
+    double below = 0;
+    for (size_t i = 0; i < recentScores.size(); i++) {
+        if (recentScores[i] < score) {
+            below += 1;
+        } else if (recentScores[i] == score) {
+            below += 0.5;
+        }
+    }
+    return below / recentScores.size();
+}
+
+// one line per arm that was tried
+void PerturbationBandit::print(ostream &output) const {
+    lock_guard<mutex> guard(lock);
+    output << "Adaptive perturbation: seeds, average reward, best score, "
+              "current weight" << endl;
+    for (size_t i = 0; i < arms.size(); i++) {
+        const ArmStats &arm = stats[i];
+        if (arm.seeds == 0) {
+            continue;
+        }
+        output << "    " << constructionName(arms[i].construction) 
+               << ", noise " << 1 / arms[i].noiseDivisor << ": " << arm.seeds 
+               << ", " << arm.totalReward / arm.seeds << ", " << arm.bestScore 
+               << ", " << arm.weight << endl;
+    }
+}
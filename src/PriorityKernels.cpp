@@ -0,0 +1,221 @@
+#include "PriorityKernels.h"
+
+// build with -DPRIORITY_KERNELS_SCALAR to always use the scalar kernels
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(PRIORITY_KERNELS_SCALAR)
+#define PRIORITY_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+/******************************* Scalar Kernels *******************************/
+
+static void addNoiseScalar(const Fixed *base, const double *noise,
+                           double divisor, Fixed *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = base[i] + toFixed(noise[i] / divisor);
+    }
+}
+
+static pair<Fixed, Fixed> findMinMaxScalar(const Fixed *values, size_t n) {
+    if (n == 0) {
+        return {0, 0};
+    }
+
+    Fixed low = values[0];
+    Fixed high = values[0];
+    for (size_t i = 1; i < n; i++) {
+        low = min(low, values[i]);
+        high = max(high, values[i]);
+    }
+    return {low, high};
+}
+
+static void normalizeScalar(Fixed *values, size_t n, Fixed low, Fixed high) {
+    double range = fromFixed(high - low);
+    for (size_t i = 0; i < n; i++) {
+        values[i] = toFixed(fromFixed(values[i] - low) / range);
+    }
+}
+
+static void segmentSumsScalar(const Fixed *values, const int *offsets,
+                              size_t numSegments, Fixed *sums) {
+    for (size_t i = 0; i < numSegments; i++) {
+        Fixed sum = 0;
+        for (int j = offsets[i]; j < offsets[i + 1]; j++) {
+            sum += values[j];
+        }
+        sums[i] = sum;
+    }
+}
+
+/******************************** AVX2 Kernels ********************************/
+
+#ifdef PRIORITY_KERNELS_X86
+
+// AVX2 has no conversions between int64 and double. Adding 2^52 + 2^51 to an
+// integral double below 2^51 in size puts the integer in the low mantissa
+// bits, so they can be moved across exactly by reinterpreting the bits
+static const double SIGNED_MAGIC = 0x1.8p52;
+
+__attribute__((target("avx2")))
+static inline __m256i integralToFixed(__m256d values) {
+    __m256d magic = _mm256_set1_pd(SIGNED_MAGIC);
+    __m256i bits = _mm256_castpd_si256(_mm256_add_pd(values, magic));
+    return _mm256_sub_epi64(bits, _mm256_castpd_si256(magic));
+}
+
+__attribute__((target("avx2")))
+static inline __m256d fixedToIntegral(__m256i values) {
+    __m256d magic = _mm256_set1_pd(SIGNED_MAGIC);
+    __m256i bits = _mm256_add_epi64(values, _mm256_castpd_si256(magic));
+    return _mm256_sub_pd(_mm256_castsi256_pd(bits), magic);
+}
+
+// the same operations as toFixed: scale, add half away from zero, truncate
+__attribute__((target("avx2")))
+static inline __m256i roundToFixed(__m256d values) {
+    __m256d half = _mm256_set1_pd(0.5);
+    __m256d negative = _mm256_cmp_pd(values, _mm256_setzero_pd(), _CMP_LT_OQ);
+    half = _mm256_blendv_pd(half, _mm256_set1_pd(-0.5), negative);
+    __m256d scaled = _mm256_add_pd(
+        _mm256_mul_pd(values, _mm256_set1_pd((double) FIXED_ONE)), half);
+    return integralToFixed(_mm256_round_pd(scaled, _MM_FROUND_TO_ZERO |
+                                                   _MM_FROUND_NO_EXC));
+}
+
+__attribute__((target("avx2")))
+static void addNoiseAvx2(const Fixed *base, const double *noise,
+                         double divisor, Fixed *out, size_t n) {
+    __m256d divisors = _mm256_set1_pd(divisor);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d wiggle = _mm256_div_pd(_mm256_loadu_pd(noise + i), divisors);
+        __m256i sum = _mm256_add_epi64(
+            _mm256_loadu_si256((const __m256i *) (base + i)),
+            roundToFixed(wiggle));
+        _mm256_storeu_si256((__m256i *) (out + i), sum);
+    }
+    addNoiseScalar(base + i, noise + i, divisor, out + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static pair<Fixed, Fixed> findMinMaxAvx2(const Fixed *values, size_t n) {
+    if (n < 4) {
+        return findMinMaxScalar(values, n);
+    }
+
+    __m256i low = _mm256_loadu_si256((const __m256i *) values);
+    __m256i high = low;
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256i curr = _mm256_loadu_si256((const __m256i *) (values + i));
+        low = _mm256_blendv_epi8(low, curr, _mm256_cmpgt_epi64(low, curr));
+        high = _mm256_blendv_epi8(high, curr, _mm256_cmpgt_epi64(curr, high));
+    }
+
+    alignas(32) Fixed lows[4];
+    alignas(32) Fixed highs[4];
+    _mm256_store_si256((__m256i *) lows, low);
+    _mm256_store_si256((__m256i *) highs, high);
+    pair<Fixed, Fixed> result = {lows[0], highs[0]};
+    for (int lane = 1; lane < 4; lane++) {
+        result.first = min(result.first, lows[lane]);
+        result.second = max(result.second, highs[lane]);
+    }
+    for (; i < n; i++) {
+        result.first = min(result.first, values[i]);
+        result.second = max(result.second, values[i]);
+    }
+    return result;
+}
+
+__attribute__((target("avx2")))
+static void normalizeAvx2(Fixed *values, size_t n, Fixed low, Fixed high) {
+    // values - low has to convert to a double exactly
+    if (high - low >= ((Fixed) 1 << 51)) {
+        normalizeScalar(values, n, low, high);
+        return;
+    }
+
+    __m256d range = _mm256_set1_pd(fromFixed(high - low));
+    __m256d unit = _mm256_set1_pd((double) FIXED_ONE);
+    __m256i lows = _mm256_set1_epi64x(low);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i shifted = _mm256_sub_epi64(
+            _mm256_loadu_si256((const __m256i *) (values + i)), lows);
+        __m256d scaled = _mm256_div_pd(fixedToIntegral(shifted), unit);
+        _mm256_storeu_si256((__m256i *) (values + i),
+                            roundToFixed(_mm256_div_pd(scaled, range)));
+    }
+    normalizeScalar(values + i, n - i, low, high);
+}
+
+// segments are a worker's shifts and usually short. Below
+// SEGMENT_VECTOR_LENGTH, adding the lanes together costs more than it saves,
+// so short segments are summed one value at a time
+static const int SEGMENT_VECTOR_LENGTH = 32;
+
+__attribute__((target("avx2")))
+static void segmentSumsAvx2(const Fixed *values, const int *offsets,
+                            size_t numSegments, Fixed *sums) {
+    for (size_t s = 0; s < numSegments; s++) {
+        int i = offsets[s];
+        int end = offsets[s + 1];
+        Fixed sum = 0;
+        if (end - i >= SEGMENT_VECTOR_LENGTH) {
+            __m256i lanes = _mm256_setzero_si256();
+            for (; i + 4 <= end; i += 4) {
+                lanes = _mm256_add_epi64(
+                    lanes, _mm256_loadu_si256((const __m256i *) (values + i)));
+            }
+            alignas(32) Fixed parts[4];
+            _mm256_store_si256((__m256i *) parts, lanes);
+            sum = parts[0] + parts[1] + parts[2] + parts[3];
+        }
+        for (; i < end; i++) {
+            sum += values[i];
+        }
+        sums[s] = sum;
+    }
+}
+
+#endif
+
+/********************************** Dispatch **********************************/
+
+// chosen once, the first time any kernel is called
+const PriorityKernels::Table &PriorityKernels::table() {
+    static const Table chosen = []() {
+#ifdef PRIORITY_KERNELS_X86
+        if (__builtin_cpu_supports("avx2")) {
+            return Table{true, addNoiseAvx2, findMinMaxAvx2, normalizeAvx2,
+                         segmentSumsAvx2};
+        }
+#endif
+        return Table{false, addNoiseScalar, findMinMaxScalar, normalizeScalar,
+                     segmentSumsScalar};
+    }();
+    return chosen;
+}
+
+bool PriorityKernels::usingAvx2() {
+    return table().avx2;
+}
+
+void PriorityKernels::addNoise(const Fixed *base, const double *noise,
+                               double divisor, Fixed *out, size_t n) {
+    table().addNoise(base, noise, divisor, out, n);
+}
+
+pair<Fixed, Fixed> PriorityKernels::findMinMax(const Fixed *values, size_t n) {
+    return table().findMinMax(values, n);
+}
+
+void PriorityKernels::normalize(Fixed *values, size_t n, Fixed low, Fixed high) {
+    table().normalize(values, n, low, high);
+}
+
+void PriorityKernels::segmentSums(const Fixed *values, const int *offsets,
+                                  size_t numSegments, Fixed *sums) {
+    table().segmentSums(values, offsets, numSegments, sums);
+}
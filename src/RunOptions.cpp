@@ -0,0 +1,234 @@
+#include "RunOptions.h"
+
+#include <math.h>
+
+static bool startsWith(const string &arg, const string &prefix);
+static unsigned int parseSeed(const string &value, const string &arg);
+static int parsePositive(const string &value, const string &arg);
+static double parseNonNegative(const string &value, const string &arg);
+static double parsePositiveReal(const string &value, const string &arg);
+
+// throws a runtime_error with a user facing message on bad arguments
+RunOptions parseRunOptions(int argc, char *argv[]) {
+    RunOptions options;
+    bool perturbationGiven = false;  // --construction or --noise
+    bool rangeGiven = false;         // --seed-range
+    if (argc < 2) {
+        throw runtime_error("Error: missing input directory or file");
+    }
+
+    if (string(argv[1]) == "merge") {
+        options.merge = true;
+    } else {
+        options.inputPath = argv[1];
+    }
+
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (startsWith(arg, "--seed=")) {
+            options.singleSeed = true;
+            options.seed = parseSeed(arg.substr(7), arg);
+        } else if (startsWith(arg, "--seed-range=")) {
+            string range = arg.substr(13);
+            size_t colon = range.find(':');
+            if (colon == string::npos) {
+                throw runtime_error("Error: expected START:END in " + arg);
+            }
+            options.firstSeed = parseSeed(range.substr(0, colon), arg);
+            options.lastSeed = parseSeed(range.substr(colon + 1), arg);
+            if (options.firstSeed > options.lastSeed) {
+                throw runtime_error("Error: empty seed range in " + arg);
+            }
+            rangeGiven = true;
+        } else if (startsWith(arg, "--result-out=")) {
+            options.resultOut = arg.substr(13);
+        } else if (arg == "--batch-balance") {
+            options.batchBalance = true;
+        } else if (arg == "--components") {
+            options.components = true;
+        } else if (arg == "--exact") {
+            options.exact = true;
+        } else if (arg == "--presolve") {
+            options.presolve = true;
+        } else if (arg == "--validate=off") {
+            options.validation = Validation::OFF;
+        } else if (arg == "--validate=fast") {
+            options.validation = Validation::FAST;
+        } else if (arg == "--validate=full") {
+            options.validation = Validation::FULL;
+        } else if (startsWith(arg, "--threads=")) {
+            options.threads = parsePositive(arg.substr(10), arg);
+        } else if (arg == "--prune") {
+            options.pruneSafety = 2;
+        } else if (startsWith(arg, "--prune=")) {
+            options.pruneSafety = parseNonNegative(arg.substr(8), arg);
+        } else if (arg == "--elite") {
+            options.elite = 8;
+        } else if (startsWith(arg, "--elite=")) {
+            options.elite = parsePositive(arg.substr(8), arg);
+        } else if (startsWith(arg, "--lns=")) {
+            options.refine = parsePositive(arg.substr(6), arg);
+        } else if (startsWith(arg, "--gap=")) {
+            options.gap = parseNonNegative(arg.substr(6), arg);
+        } else if (arg == "--skip-repeats") {
+            options.skipRepeats = true;
+        } else if (arg == "--adaptive") {
+            options.adaptive = true;
+        } else if (startsWith(arg, "--noise=")) {
+            options.noiseDivisor = 1 / parsePositiveReal(arg.substr(8), arg);
+            perturbationGiven = true;
+        } else if (startsWith(arg, "--pareto=")) {
+            options.paretoOut = arg.substr(9);
+        } else if (startsWith(arg, "--scenarios=")) {
+            options.scenarioFile = arg.substr(12);
+        } else if (startsWith(arg, "--seed-log=")) {
+            options.seedLog = arg.substr(11);
+        } else if (startsWith(arg, "--construction=")) {
+            perturbationGiven = true;
+            string name = arg.substr(15);
+            if (name == "portfolio") {
+                options.portfolio = true;
+            } else if (!parseConstruction(name, options.construction)) {
+                throw runtime_error("Error: unknown construction in " + arg);
+            }
+        } else if (startsWith(arg, "--search-threads=")) {
+            options.searchThreads = parsePositive(arg.substr(17), arg);
+        } else if (options.merge and not startsWith(arg, "--")) {
+            options.mergeFiles.push_back(arg);
+        } else {
+            throw runtime_error("Error: unknown argument " + arg);
+        }
+    }
+
+    if (options.threads > 1 and options.searchThreads > 1) {
+        throw runtime_error("Error: --threads and --search-threads cannot "
+                            "be combined");
+    }
+    if (options.elite > 0 and options.singleSeed) {
+        throw runtime_error("Error: --elite relinks the results of a sweep, "
+                            "it cannot be combined with --seed");
+    }
+    if (options.components and options.singleSeed) {
+        throw runtime_error("Error: --components sweeps a range of seeds, "
+                            "it cannot be combined with --seed");
+    }
+    if (options.adaptive and (options.singleSeed or perturbationGiven)) {
+        throw runtime_error("Error: --adaptive picks the construction and "
+                            "noise of every seed of a sweep, it cannot be "
+                            "combined with --seed, --construction or --noise");
+    }
+    if (options.seedLog != "" and (options.singleSeed or options.components)) {
+        throw runtime_error("Error: --seed-log logs a single sweep, it cannot "
+                            "be combined with --seed or --components");
+    }
+    if (options.exact and (options.singleSeed or options.components or 
+                           options.elite > 0 or options.adaptive)) {
+        throw runtime_error("Error: --exact searches every schedule, it cannot "
+                            "be combined with --seed, --components, --elite "
+                            "or --adaptive");
+    }
+    if (options.scenarioFile != "" and 
+        (options.singleSeed or options.components or options.exact or
+         options.seedLog != "" or options.resultOut != "")) {
+        throw runtime_error("Error: --scenarios compares the sweeps of "
+                            "several scenarios, it cannot be combined with "
+                            "--seed, --components, --exact, --seed-log or "
+                            "--result-out");
+    }
+    // the scenarios are swept one after another with a single thread, so
+    // a sweep until <Ctrl-C> would leave the others unswept
+    if (options.scenarioFile != "" and not rangeGiven) {
+        throw runtime_error("Error: --scenarios needs --seed-range");
+    }
+    if (options.paretoOut != "" and 
+        (options.singleSeed or options.components or options.exact or
+         options.scenarioFile != "" or options.pruneSafety > 0)) {
+        throw runtime_error("Error: --pareto keeps the seeds of a single "
+                            "sweep that are run to the end, it cannot be "
+                            "combined with --seed, --components, --exact, "
+                            "--scenarios or --prune");
+    }
+    if (options.merge and options.mergeFiles.empty()) {
+        throw runtime_error("Error: merge needs at least one result file");
+    }
+    return options;
+}
+
+void printUsage(ostream &output) {
+    output << "usage: ./workerScheduler [inputFileDirectory|bulkFile|-] "
+              "(optional)[--seed=] [--seed-range=START:END] "
+              "[--result-out=FILE]" << endl
+           << "           [--search-threads=N] [--batch-balance]" << endl
+           << "           [--construction=random|constrained|regret|scarcity"
+              "|portfolio]" << endl
+           << "           [--skip-repeats] [--gap=G] [--threads=N] [--prune[=SAFETY]]" 
+           << endl
+           << "           [--validate=off|fast|full] [--presolve]" << endl
+           << "           [--components] [--lns=N] [--elite[=K]]" << endl
+           << "           [--noise=X] [--adaptive] [--seed-log=FILE] [--exact]" 
+           << endl
+           << "           [--scenarios=FILE] [--pareto=FILE]" << endl
+           << "       ./workerScheduler merge [resultFile...] "
+              "(optional)[--result-out=FILE]" << endl;
+}
+
+static bool startsWith(const string &arg, const string &prefix) {
+    return arg.compare(0, prefix.size(), prefix) == 0;
+}
+
+static unsigned int parseSeed(const string &value, const string &arg) {
+    size_t used = 0;
+    unsigned long seed = 0;
+    try {
+        seed = stoul(value, &used);
+    } catch (const logic_error &) {
+        used = 0;
+    }
+    if (used == 0 or used != value.size() or seed >= UINT_MAX) {
+        throw runtime_error("Error: invalid seed in " + arg);
+    }
+    return seed;
+}
+
+static int parsePositive(const string &value, const string &arg) {
+    size_t used = 0;
+    int number = 0;
+    try {
+        number = stoi(value, &used);
+    } catch (const logic_error &) {
+        used = 0;
+    }
+    if (used == 0 or used != value.size() or number < 1) {
+        throw runtime_error("Error: expected a positive number in " + arg);
+    }
+    return number;
+}
+
+static double parseNonNegative(const string &value, const string &arg) {
+    size_t used = 0;
+    double number = -1;
+    try {
+        number = stod(value, &used);
+    } catch (const logic_error &) {
+        used = 0;
+    }
+    if (used == 0 or used != value.size() or not (number >= 0)) {
+        throw runtime_error("Error: expected a non-negative number in " + arg);
+    }
+    return number;
+}
+
+static double parsePositiveReal(const string &value, const string &arg) {
+    size_t used = 0;
+    double number = 0;
+    try {
+        number = stod(value, &used);
+    } catch (const logic_error &) {
+        used = 0;
+    }
+    if (used == 0 or used != value.size() or not (number > 0) or 
+        isinf(number)) {
+        throw runtime_error("Error: expected a positive number in " + arg);
+    }
+    return number;
+}
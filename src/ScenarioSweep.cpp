@@ -0,0 +1,283 @@
+#include "ScenarioSweep.h"
+
+static int findName(const string &name, const string names[], int numNames);
+static double parseReal(const string &value, const string &line);
+static int parseCount(const string &value, const string &line);
+
+ScenarioSweep::ScenarioSweep(WorkerInputData &data, const RunOptions &options,
+                             ThreadPool *newPool)
+    : inputData(data), scenarioOptions(options) {
+    pool = newPool;
+    secondsTaken = 0;
+
+    Scenario baseline;
+    baseline.name = "baseline";
+    scenarios.push_back(baseline);
+    readScenarios(options.scenarioFile);
+
+    // --threads sweeps that many scenarios at once instead of splitting the
+    // seeds of one
+    numThreads = min(options.threads, (int) scenarios.size());
+    scenarioOptions.threads = 1;
+
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        scenarioData.emplace_back(new WorkerInputData(inputData));
+        apply(scenarios[i], *scenarioData[i]);
+        sweeps.emplace_back(new SeedSweep(*scenarioData[i], scenarioOptions,
+                                          pool));
+        sweeps[i]->setLabel(scenarios[i].name + ": ");
+    }
+}
+
+int ScenarioSweep::getNumScenarios() const {
+    return scenarios.size();
+}
+
+/********************************** Reading ***********************************/
+
+// throws a runtime_error naming the line if the file cannot be read
+void ScenarioSweep::readScenarios(const string &fileName) {
+    ifstream input(fileName);
+    if (!input.is_open()) {
+        throw runtime_error("Error: could not open scenario file " + fileName);
+    }
+
+    string line;
+    int lineNumber = 0;
+    while (getline(input, line)) {
+        lineNumber++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == string::npos or line[first] == '#') {
+            continue;
+        }
+        line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+
+        try {
+            if (line.front() == '[') {
+                if (line.back() != ']' or line.size() == 2) {
+                    throw runtime_error("expected [name]");
+                }
+                Scenario scenario;
+                scenario.name = line.substr(1, line.size() - 2);
+                scenarios.push_back(scenario);
+            } else if (scenarios.size() == 1) {
+                throw runtime_error("a change before the first [name]");
+            } else {
+                readChange(scenarios.back(), line);
+            }
+        } catch (const runtime_error &e) {
+            throw runtime_error("Error: line " + to_string(lineNumber) + " of "
+                                + fileName + ": " + e.what());
+        }
+    }
+    if (scenarios.size() == 1) {
+        throw runtime_error("Error: no scenarios in " + fileName);
+    }
+}
+
+void ScenarioSweep::readChange(Scenario &scenario, const string &line) {
+    istringstream words(line);
+    string key, dayName, shiftName, value, extra;
+    words >> key;
+    Weight weight;
+    if (key == "shift") {
+        words >> dayName >> shiftName >> value;
+        Scenario::Staffing staffing;
+        staffing.day = dayName == "all" ? -1
+                                        : findName(dayName, dayNames, NUM_DAYS);
+        staffing.shift = shiftName == "all" ? -1
+                         : findName(shiftName, shiftNames, MAX_SHIFTS);
+        if (dayName == "" or (dayName != "all" and staffing.day == -1)) {
+            throw runtime_error("unknown day in " + line);
+        }
+        if (shiftName == "" or (shiftName != "all" and staffing.shift == -1)) {
+            throw runtime_error("unknown shift in " + line);
+        }
+        staffing.needed = parseCount(value, line);
+        scenario.staffing.push_back(staffing);
+    } else if (parseWeight(key, weight)) {
+        words >> value;
+        scenario.weights.push_back({weight, parseReal(value, line)});
+    } else {
+        throw runtime_error("unknown change " + key);
+    }
+    if (words >> extra) {
+        throw runtime_error("unexpected " + extra + " in " + line);
+    }
+    scenario.changes.push_back(line);
+}
+
+// in the order they were written, so a later change wins
+void ScenarioSweep::apply(const Scenario &scenario, WorkerInputData &data) {
+    try {
+        for (size_t i = 0; i < scenario.staffing.size(); i++) {
+            const Scenario::Staffing &staffing = scenario.staffing[i];
+            for (int day = 0; day < NUM_DAYS; day++) {
+                for (int shift = 0; shift < MAX_SHIFTS; shift++) {
+                    if ((staffing.day == -1 or staffing.day == day) and
+                        (staffing.shift == -1 or staffing.shift == shift)) {
+                        data.setWorkersPerShift(day, shift, staffing.needed);
+                    }
+                }
+            }
+        }
+        for (size_t i = 0; i < scenario.weights.size(); i++) {
+            data.setWeight(scenario.weights[i].first,
+                           scenario.weights[i].second);
+        }
+    } catch (const runtime_error &e) {
+        throw runtime_error(string(e.what()) + " (scenario " + scenario.name
+                            + ")");
+    }
+}
+
+static int findName(const string &name, const string names[], int numNames) {
+    for (int i = 0; i < numNames; i++) {
+        if (names[i] == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static double parseReal(const string &value, const string &line) {
+    size_t used = 0;
+    double number = 0;
+    try {
+        number = stod(value, &used);
+    } catch (const logic_error &) {
+        used = 0;
+    }
+    if (used == 0 or used != value.size()) {
+        throw runtime_error("expected a number in " + line);
+    }
+    return number;
+}
+
+static int parseCount(const string &value, const string &line) {
+    size_t used = 0;
+    int number = -1;
+    try {
+        number = stoi(value, &used);
+    } catch (const logic_error &) {
+        used = 0;
+    }
+    if (used == 0 or used != value.size() or number < 0) {
+        throw runtime_error("expected a number of workers in " + line);
+    }
+    return number;
+}
+
+/********************************** Sweeping **********************************/
+
+// the scenarios are close in size, so they are simply taken in order
+void ScenarioSweep::run(const atomic<bool> &keepGoing) {
+    auto t1 = chrono::high_resolution_clock::now();
+
+    auto sweep = [&](int index, int thread) {
+        (void) thread;
+        runScenario(index, keepGoing);
+    };
+    if (numThreads == 1) {
+        for (size_t i = 0; i < scenarios.size(); i++) {
+            sweep(i, 0);
+        }
+    } else {
+        ThreadPool scenarioPool(numThreads);
+        scenarioPool.parallelFor(scenarios.size(), sweep);
+    }
+
+    auto t2 = chrono::high_resolution_clock::now();
+    auto ms_int = chrono::duration_cast<chrono::milliseconds>(t2 - t1);
+    secondsTaken = (double) ms_int.count() / 1000;
+}
+
+// sweeps one scenario, then runs its best seed again, or loads the schedule
+// path relinking found, for the parts of its score. Refined with --lns, as
+// a single run's result would be
+void ScenarioSweep::runScenario(int index, const atomic<bool> &keepGoing) {
+    Scenario &scenario = scenarios[index];
+    SeedSweep &sweep = *sweeps[index];
+    WorkerInputData &data = *scenarioData[index];
+    sweep.run(keepGoing);
+
+    const EliteSchedule *relinked = sweep.getRelinkedBest();
+    scenario.seedsChecked = sweep.getSeedsChecked();
+    if (scenario.seedsChecked == 0) {
+        return;  // interrupted before it started
+    }
+    scenario.bestSeed = relinked ? relinked->seed : sweep.getBestSeed();
+    Scheduler scheduler(data, scenario.bestSeed);
+    SeedSweep::configureScheduler(scheduler, scenarioOptions, pool);
+    scheduler.setPerturbation(relinked ? relinked->perturbation
+                                       : sweep.getBestPerturbation());
+    if (relinked != nullptr) {
+        const vector<TimeSlotNode *> &slotList = data.getSlotList();
+        vector<TimeSlotNode *> slots;
+        for (size_t i = 0; i < relinked->slotIds.size(); i++) {
+            slots.push_back(slotList[relinked->slotIds[i]]);
+        }
+        scheduler.loadSchedule(slots);
+    } else {
+        scheduler.calculate();
+    }
+    if (scenarioOptions.refine > 0) {
+        scheduler.refine(scenarioOptions.refine);
+    }
+
+    scenario.score = scheduler.getScore();
+    scenario.average = scheduler.getAverage();
+    scenario.lowest = scheduler.getLeastHappy();
+    scenario.range = scheduler.getRange();
+}
+
+/********************************** Printing **********************************/
+
+void ScenarioSweep::printScenarios(ostream &output) const {
+    for (size_t i = 1; i < scenarios.size(); i++) {
+        output << "Scenario " << scenarios[i].name << ":";
+        for (size_t j = 0; j < scenarios[i].changes.size(); j++) {
+            output << (j == 0 ? " " : ", ") << scenarios[i].changes[j];
+        }
+        output << endl;
+    }
+}
+
+// scores use each scenario's own proportions, so they only compare between
+// scenarios that keep them; the average and lowest always compare
+void ScenarioSweep::printTable(ostream &output) const {
+    size_t nameWidth = 8;
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        nameWidth = max(nameWidth, scenarios[i].name.size());
+    }
+
+    ios oldState(nullptr);
+    oldState.copyfmt(output);
+    output << fixed << setprecision(4);
+    output << left << setw(nameWidth) << "Scenario" << right
+           << setw(10) << "Score" << setw(10) << "Average"
+           << setw(10) << "Lowest" << setw(7) << "Range"
+           << setw(11) << "Average +-" << setw(10) << "Lowest +-"
+           << setw(12) << "Best seed" << setw(8) << "Seeds" << endl;
+    const Scenario &baseline = scenarios.front();
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        const Scenario &scenario = scenarios[i];
+        output << left << setw(nameWidth) << scenario.name << right;
+        if (scenario.seedsChecked == 0) {
+            output << "  not swept" << endl;
+            continue;
+        }
+        output << setw(10) << scenario.score << setw(10) << scenario.average
+               << setw(10) << scenario.lowest << setw(7) << scenario.range
+               << showpos << setw(11) << scenario.average - baseline.average
+               << setw(10) << scenario.lowest - baseline.lowest << noshowpos
+               << setw(12) << scenario.bestSeed
+               << setw(8) << scenario.seedsChecked << endl;
+    }
+    output.copyfmt(oldState);
+}
+
+void ScenarioSweep::printProfile(ostream &output) const {
+    output << "Time taken (s): " << secondsTaken << endl;
+    output << "Scenarios swept at once: " << numThreads << endl;
+}
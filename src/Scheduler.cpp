@@ -2,46 +2,230 @@
 
 /********************************* Constructor ********************************/
 
-Scheduler::Scheduler(WorkerInputData &data, unsigned int newSeed) : inputData(data) {
+Scheduler::Scheduler(WorkerInputData &data, unsigned int newSeed)
+    : inputData(data), rng(newSeed) {
+    // capacity for everything that is refilled on every run
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            finalSchedule[i][j].reserve(inputData.getWorkersPerShift(i, j));
+        }
+    }
+    shiftOrder.reserve(NUM_DAYS * MAX_SHIFTS);
+    batchBalance = false;
+    batchWorkers.reserve(inputData.getNumWorkers());
+    bestPath.reserve(inputData.getSlotList().size());
+    workerLock.assign(inputData.getNumWorkers(), 0);
+    lockRound = 0;
+    journaling = false;
+    shiftEmptied.assign(NUM_DAYS * MAX_SHIFTS, false);
+    inGuide.assign(inputData.getSlotList().size(), false);
+    guideShifts.resize(NUM_DAYS * MAX_SHIFTS);
+
+    construction = Construction::RANDOM;
+    noiseDivisor = DEFAULT_NOISE_DIVISOR;
+
+    // the same keys for every seed and every Scheduler, so hashes compare
+    CounterRandom zobrist(ZOBRIST_KEY);
+    const vector<TimeSlotNode *> &slotList = inputData.getSlotList();
+    int numSlots = slotList.size();
+    slotKeys.resize(numSlots);
+    for (int i = 0; i < numSlots; i++) {
+        int symmetryClass = inputData.getSymmetryClass(slotList[i]->getParent()->getId());
+        slotKeys[i] = zobrist.at(symmetryClass, column(slotList[i]));
+    }
+    workerHashes.resize(inputData.getNumWorkers());
+    twinClasses.resize(inputData.getNumWorkers());
+    for (int i = 0; i < inputData.getNumWorkers(); i++) {
+        int symmetryClass = inputData.getSymmetryClass(i);
+        bool alone = inputData.getClassSize(symmetryClass) == 1;
+        twinClasses[i] = alone ? -1 : symmetryClass;
+    }
+    truePriorities.resize(numSlots);
+    priorities.resize(numSlots);
+    for (int i = 0; i < numSlots; i++) {
+        truePriorities[i] = slotList[i]->getTruePriority();
+    }
+    allocationValues.reserve(numSlots);
+    allocationOffsets.resize(inputData.getNumWorkers() + 1);
+    workerSums.resize(inputData.getNumWorkers());
+
+    regrets.resize(NUM_DAYS * MAX_SHIFTS);
+    workerOrder.reserve(inputData.getNumWorkers());
+
+    // who likes each worker, for updating the bonuses in initialOneSlot
+    candidates.resize(inputData.getSlotList().size());
+    topKeys.reserve(inputData.getSlotList().size());
+    topPriority.reserve(inputData.getSlotList().size());
+    shiftSlot.assign(inputData.getNumWorkers(), nullptr);
+    nextTwin.assign(inputData.getSlotList().size(), -1);
+    twinChains.reserve(inputData.getNumWorkers());
+    likedBy.assign(inputData.getNumWorkers(), vector<int>());
+    for (int i = 0; i < inputData.getNumWorkers(); i++) {
+        const unordered_set<WorkerNode *> &likes = inputData.getWorker(i)->getLikedCoworkers();
+        for (auto it = likes.begin(); it != likes.end(); it++) {
+            likedBy[(*it)->getId()].push_back(i);
+        }
+    }
+
+    int numWorkers = inputData.getNumWorkers();
+    availableColumns.assign(numWorkers, ColumnMask());
+    searchedColumns.assign(numWorkers, ColumnMask());
+    for (int i = 0; i < numWorkers; i++) {
+        const vector<TimeSlotNode *> &slots = inputData.getWorker(i)->getAvailability();
+        for (size_t j = 0; j < slots.size(); j++) {
+            availableColumns[i].set(column(slots[j]));
+        }
+    }
+
+    validation = DEFAULT_VALIDATION;
+    workerStamps.assign(inputData.getNumWorkers(), 0);
+    pruner = nullptr;
+    checkpointScores.reserve(SeedPruner::MAX_CHECKPOINTS);
+    pool = nullptr;
+    setThreadPool(nullptr);
+
+    reset(newSeed);
+}
+
+// searches use one scratch space per thread of the pool
+void Scheduler::setThreadPool(ThreadPool *newPool) {
+    pool = newPool;
+
+    int numSlots = inputData.getSlotList().size();
+    scratches.resize(pool == nullptr ? 1 : pool->getNumThreads());
+    for (size_t i = 0; i < scratches.size(); i++) {
+        scratches[i].seen.assign(numSlots, false);
+        scratches[i].prev.assign(numSlots, -1);
+        scratches[i].touched.reserve(numSlots);
+        scratches[i].paths.resize(numSlots);
+        scratches[i].bestPath.reserve(numSlots);
+    }
+}
+
+// prepares for a run with a new seed. Containers keep their capacity from
+// previous runs, so once warmed up a run does no heap allocations
+void Scheduler::reset(unsigned int newSeed) {
     seed = newSeed;
     calculated = false;
-    addTinyPriorityChange(newSeed);
+    abandoned = false;
+    checkpointScores.clear();
+    stateHash = 0;
+    fill(workerHashes.begin(), workerHashes.end(), 0);
+    balanceIterations = 0;
+    changedColumns.reset();
+    rng.setSeed(newSeed);
+
+    inputData.resetValues();
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            finalSchedule[i][j].clear();
+        }
+    }
+
+    addTinyPriorityChange();
 }
 
-// normalizes priorities based on (X - min) / (max - min) = newPriority
-void Scheduler::addTinyPriorityChange(unsigned int randSeed) {
-    srand(randSeed);
-    int n = inputData.getNumWorkers();
+// how much of each finished schedule is checked
+void Scheduler::setValidation(Validation newValidation) {
+    validation = newValidation;
+}
 
-    for (int i = 0; i < n; i++) {
-        const vector<TimeSlotNode *> &timeslots = inputData.getWorker(i)->getAvailability();
-        for (auto slot = timeslots.begin(); slot != timeslots.end(); slot++) {
-            // tiny change adds some minor variance so that this can be rerun
-            // with different random values, and get different (maybe better)
-            // results
-            double tinyChange = ((double)rand() / RAND_MAX) / tinyChangeDivisor;
-            double wiggledPriority = (*slot)->getTruePriority() + tinyChange;
+// lets graphBalance give up on seeds that the pruner finds hopeless
+void Scheduler::setPruner(SeedPruner *newPruner) {
+    pruner = newPruner;
+}
 
-            (*slot)->setPriority(wiggledPriority);
-        }
+// how the initial allocation is built, read when calculate is called
+void Scheduler::setConstruction(Construction newConstruction) {
+    construction = newConstruction;
+}
+
+// how much noise is added to the priorities. Applied to the current seed
+// right away, so it can be set between reset and calculate
+void Scheduler::setNoiseDivisor(double newDivisor) {
+    if (newDivisor == noiseDivisor) {
+        return;
+    }
+    noiseDivisor = newDivisor;
+    addTinyPriorityChange();
+}
+
+void Scheduler::setPerturbation(const Perturbation &perturbation) {
+    setConstruction(perturbation.construction);
+    setNoiseDivisor(perturbation.noiseDivisor);
+}
+
+// find several disjoint paths per round of graphBalance instead of one
+void Scheduler::setBatchBalance(bool newValue) {
+    batchBalance = newValue;
+}
+
+// adds the seed's noise on top of every slot's normalized priority
+void Scheduler::addTinyPriorityChange() {
+    const vector<TimeSlotNode *> &slots = inputData.getSlotList();
+
+    // tiny change adds some minor variance so that this can be rerun with
+    // different random values, and get different (maybe better) results.
+    // Noise for slot i depends only on (seed, i), so it is generated for
+    // the whole slot array in one pass
+    tinyChanges.resize(slots.size());
+    rng.fillUniform(tinyChanges.data(), tinyChanges.size(), NOISE_STREAM);
+    PriorityKernels::addNoise(truePriorities.data(), tinyChanges.data(), 
+                              noiseDivisor, priorities.data(), slots.size());
+
+    for (size_t i = 0; i < slots.size(); i++) {
+        slots[i]->setPriority(priorities[i]);
     }
 }
 
 /***************************** Schedule Population ****************************/
 
 void Scheduler::calculate() {
-    calculated = true;
+    construct();
+    balance();
+}
+
+// the first half of calculate: the initial allocation only
+void Scheduler::construct() {
     initialAllocation();
+}
+
+// the second half of calculate, after construct. An abandoned seed is left
+// part way through and cannot be scored
+void Scheduler::balance() {
     graphBalance();
+    if (abandoned) {
+        return;
+    }
 
+    calculated = true;
     validateSolution();  // check to make sure nothing went wrong
 }
 
+// takes a finished schedule instead of calculating one, e.g. one put together
+// from the components of the input. slots are of this Scheduler's input
+void Scheduler::loadSchedule(const vector<TimeSlotNode *> &slots) {
+    reset(seed);
+    for (size_t i = 0; i < slots.size(); i++) {
+        addAllocation(slots[i]);
+    }
+
+    calculated = true;
+    validateSolution();
+}
+
 // takes a timeslot node and adds it to the final schedule
 void Scheduler::addAllocation(TimeSlotNode *toAssign) {
     int day = toAssign->getDay();
     int shift = toAssign->getShift();
     finalSchedule[day][shift].push_back(toAssign);
+    if (journaling) {
+        journal.push_back({toAssign, true});
+    }
+    uint64_t &workerHash = workerHashes[toAssign->getParent()->getId()];
+    stateHash -= CounterRandom::mix(workerHash);
+    workerHash ^= slotKeys[toAssign->getId()];
+    stateHash += CounterRandom::mix(workerHash);
 
     toAssign->getParent()->allocateBlock(toAssign);
 }
@@ -58,19 +242,50 @@ void Scheduler::removeAllocation(TimeSlotNode *toRemove) {
         }
     }
 
+    if (journaling) {
+        journal.push_back({toRemove, false});
+    }
+    uint64_t &workerHash = workerHashes[toRemove->getParent()->getId()];
+    stateHash -= CounterRandom::mix(workerHash);
+    workerHash ^= slotKeys[toRemove->getId()];
+    stateHash += CounterRandom::mix(workerHash);
     toRemove->getParent()->deallocateBlock(toRemove);  // remove from allocated
 }
 
 void Scheduler::initialAllocation() {
-    vector<pair<int, int>> shifts;
+    // start from the same order every run so the shuffle only depends on seed
+    vector<pair<int, int>> &shifts = shiftOrder;
+    shifts.clear();
     for (int i = 0; i < NUM_DAYS; i++) {  // loop all shifts
         for (int j = 0; j < MAX_SHIFTS; j++) {
             shifts.push_back({i, j});
         }
     }
 
-    // randomize the order of when shifts are allocated
-    shuffle(shifts.begin(), shifts.end(), default_random_engine(rand()));
+    // randomize the order of when shifts are allocated. The other
+    // constructions keep this order for ties
+    rng.shuffle(shifts, SHUFFLE_STREAM);
+
+    switch (construction) {
+    case Construction::RANDOM:
+        break;
+    case Construction::MOST_CONSTRAINED:
+        // fewest available per required first, compared without dividing
+        stable_sort(shifts.begin(), shifts.end(), 
+                    [this](const pair<int, int> &s1, const pair<int, int> &s2) {
+            return inputData.getWorkersAvailable(s1.first, s1.second).size() * 
+                       inputData.getWorkersPerShift(s2.first, s2.second) <
+                   inputData.getWorkersAvailable(s2.first, s2.second).size() * 
+                       inputData.getWorkersPerShift(s1.first, s1.second);
+        });
+        break;
+    case Construction::REGRET:
+        allocateByRegret();
+        return;
+    case Construction::SCARCITY:
+        allocateScarceWorkers();
+        break;
+    }
 
     int numShifts = NUM_DAYS * MAX_SHIFTS;
     for (int i = 0; i < numShifts; i++) {
@@ -84,61 +299,237 @@ void Scheduler::initialAllocation() {
     }
 }
 
-// initially allocate all of the TAs for one timeslot
+// repeatedly fills the shift with the highest regret. Filling a shift only
+// changes the penalties of shifts on the same day, so only those regrets are
+// calculated again
+void Scheduler::allocateByRegret() {
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            regrets[i * MAX_SHIFTS + j] = shiftRegret(i, j);
+        }
+    }
+
+    int numShifts = NUM_DAYS * MAX_SHIFTS;
+    for (int filled = 0; filled < numShifts; filled++) {
+        // ties go to the earlier shift in the shuffled order
+        int next = -1;
+        for (int i = 0; i < numShifts; i++) {
+            int index = shiftOrder[i].first * MAX_SHIFTS + shiftOrder[i].second;
+            if (regrets[index] != FILLED and 
+                (next == -1 or regrets[index] > regrets[next])) {
+                next = index;
+            }
+        }
+
+        int day = next / MAX_SHIFTS;
+        int shift = next % MAX_SHIFTS;
+        if (inputData.getWorkersPerShift(day, shift) > 0) {
+            initialOneSlot(inputData.getWorkersAvailable(day, shift));
+        }
+        regrets[next] = FILLED;
+
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            if (regrets[day * MAX_SHIFTS + j] != FILLED) {
+                regrets[day * MAX_SHIFTS + j] = shiftRegret(day, j);
+            }
+        }
+    }
+}
+
+// how much worse than its best candidate a shift has to take if it waits: the
+// gap between the best candidate and the first one past the number required.
+// Infinite if the shift needs every candidate it has
+Fixed Scheduler::shiftRegret(int day, int shift) {
+    size_t required = inputData.getWorkersPerShift(day, shift);
+    const vector<TimeSlotNode *> &currShift = inputData.getWorkersAvailable(day, shift);
+    if (currShift.size() <= required) {
+        return numeric_limits<Fixed>::max();
+    }
+
+    topKeys.clear();
+    for (auto it = currShift.begin(); it != currShift.end(); it++) {
+        topKeys.push_back((*it)->getPriority(finalSchedule, false));
+    }
+    nth_element(topKeys.begin(), topKeys.begin() + required, topKeys.end(),
+                greater<Fixed>());
+    Fixed firstLeftOut = topKeys[required];
+    Fixed best = *max_element(topKeys.begin(), topKeys.begin() + required + 1);
+    return best - firstLeftOut;
+}
+
+// worker-centric start: workers with the least availability go first, and
+// each takes their best open shifts up to an even share of all required
+// shifts. initialOneSlot fills whatever is left afterwards
+void Scheduler::allocateScarceWorkers() {
+    int numWorkers = inputData.getNumWorkers();
+    int totalRequired = 0;
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            totalRequired += inputData.getWorkersPerShift(i, j);
+        }
+    }
+    int share = totalRequired / numWorkers;
+
+    workerOrder.clear();
+    for (int i = 0; i < numWorkers; i++) {
+        workerOrder.push_back(inputData.getWorker(i));
+    }
+    rng.shuffle(workerOrder, WORKER_STREAM);
+    stable_sort(workerOrder.begin(), workerOrder.end(), 
+                [](WorkerNode *w1, WorkerNode *w2) {
+        return w1->getAvailability().size() < w2->getAvailability().size();
+    });
+
+    for (size_t i = 0; i < workerOrder.size(); i++) {
+        const vector<TimeSlotNode *> &slots = workerOrder[i]->getAvailability();
+        for (int taken = 0; taken < share; taken++) {
+            TimeSlotNode *best = nullptr;
+            Fixed bestPriority = 0;
+            for (size_t j = 0; j < slots.size(); j++) {
+                int day = slots[j]->getDay(), shift = slots[j]->getShift();
+                if (slots[j]->getUsed() or (int) finalSchedule[day][shift].size() >= 
+                                           inputData.getWorkersPerShift(day, shift)) {
+                    continue;  // taken, or shift already full
+                }
+                Fixed priority = slots[j]->getPriority(finalSchedule, false);
+                if (best == nullptr or priority > bestPriority) {
+                    best = slots[j];
+                    bestPriority = priority;
+                }
+            }
+
+            if (best == nullptr) {
+                break;
+            }
+            addAllocation(best);
+        }
+    }
+}
+
+// initially allocate all of the TAs for one timeslot. Penalties only depend
+// on a worker's own allocations, so within the shift an allocation only
+// changes the bonus of the candidates who like the worker added, and only
+// those are evaluated again
 void Scheduler::initialOneSlot(const vector<TimeSlotNode *> &currQueue) {
     if (currQueue.size() == 0) {  // shift with no available TAs
         return;
     }
 
+    candidates.clear();
+    twinChains.clear();
+    for (auto it = currQueue.begin(); it != currQueue.end(); it++) {
+        if (!(*it)->getUsed() and !deferTwin(*it)) {
+            candidates.push((*it)->getId(), (*it)->getPriority(finalSchedule, false));
+        }
+        shiftSlot[(*it)->getParent()->getId()] = *it;
+    }
+
     int day = currQueue.front()->getDay();  // all same shift time
     int shift = currQueue.front()->getShift();
-    // assigning all of the workers for this shift
-    for (int i = 0; i < inputData.getWorkersPerShift(day, shift); i++) {
-        TimeSlotNode *topTimeNode;
-        topTimeNode = findMaxTimeSlotPriority(currQueue);
-        vector<TimeSlotNode *> topPriority;
-        double highestPriority = topTimeNode->getPriority(finalSchedule, false);
-        for (auto it = currQueue.begin(); it != currQueue.end(); it++) {
-            if (!(*it)->getUsed() and
-                (*it)->getPriority(finalSchedule, false) == highestPriority) {
-                topPriority.push_back(*it);
-            }
+    // assigning the workers this shift still needs
+    int required = inputData.getWorkersPerShift(day, shift);
+    for (int i = finalSchedule[day][shift].size(); i < required; i++) {
+        TimeSlotNode *topTimeNode = findMaxTimeSlotPriority();
+        addAllocation(topTimeNode);
+
+        int twin = nextTwin[topTimeNode->getId()];
+        if (twin != -1) {
+            TimeSlotNode *twinSlot = inputData.getSlotList()[twin];
+            candidates.push(twin, twinSlot->getPriority(finalSchedule, false));
         }
-        // among the shifts with highest priority, select the person who has 
-        // the lowest number of shifts
-        int mostAvailability = INT_MIN;
-        int indexMostAvailability = -1;
-        for (size_t j = 0; j < topPriority.size(); j++) {
-            int currAvailability 
-                    = topPriority[j]->getParent()->getShiftsRemaining();
-            if (currAvailability > mostAvailability) {
-                mostAvailability = currAvailability;
-                indexMostAvailability = j;
+
+        const vector<int> &likers = likedBy[topTimeNode->getParent()->getId()];
+        for (size_t j = 0; j < likers.size(); j++) {
+            TimeSlotNode *liker = shiftSlot[likers[j]];
+            if (liker != nullptr and candidates.contains(liker->getId())) {
+                candidates.increaseKey(liker->getId(), 
+                                       liker->getPriority(finalSchedule, false));
             }
         }
-        addAllocation(topPriority[indexMostAvailability]);
     }
-}
 
-// finds the unused timeslotnode within the queue that has the highest priority
-TimeSlotNode *Scheduler::findMaxTimeSlotPriority(const vector<TimeSlotNode *> &currQueue) {
-    TimeSlotNode *topTimeNode = nullptr;
-    double highestPriority;
     for (auto it = currQueue.begin(); it != currQueue.end(); it++) {
-        if (not (*it)->getUsed() and
-            (topTimeNode == nullptr or
-             (*it)->getPriority(finalSchedule, false) > highestPriority)) {
-            topTimeNode = *it;
-            highestPriority = (*it)->getPriority(finalSchedule, false);
+        shiftSlot[(*it)->getParent()->getId()] = nullptr;
+    }
+}
+
+// chains slot behind the last slot of an earlier twin in the shift, if there
+// is one. Twins differ only by noise, so taking them in class order leaves
+// out schedules that only swap them. The queue is in worker id order, which
+// is class order
+bool Scheduler::deferTwin(TimeSlotNode *slot) {
+    nextTwin[slot->getId()] = -1;
+    int worker = slot->getParent()->getId();
+    if (twinClasses[worker] == -1) {
+        return false;
+    }
+
+    const vector<TimeSlotNode *> &slots = inputData.getSlotList();
+    for (size_t i = 0; i < twinChains.size(); i++) {
+        if (twins(slots[twinChains[i].first]->getParent()->getId(), worker)) {
+            nextTwin[twinChains[i].second] = slot->getId();
+            twinChains[i].second = slot->getId();
+            return true;
         }
     }
+    twinChains.push_back({slot->getId(), slot->getId()});
+    return false;
+}
 
-    if (topTimeNode == nullptr) {
+// interchangeable workers with the same allocations, up to hash collisions
+bool Scheduler::twins(int worker1, int worker2) const {
+    return twinClasses[worker1] == twinClasses[worker2] and
+           workerHashes[worker1] == workerHashes[worker2];
+}
+
+// takes the timeslotnode with the highest priority out of the candidates.
+// Among the ones tied with it exactly, selects the person who
+// has the most shifts remaining
+TimeSlotNode *Scheduler::findMaxTimeSlotPriority() {
+    if (candidates.empty()) {
         throw runtime_error(
             "Error: trying to allocated more time slots, but all time slots "
             "are already used");
     }
-    return topTimeNode;
+
+    // ties come out in slot id order, which is the order of the queue
+    const vector<TimeSlotNode *> &slots = inputData.getSlotList();
+    pair<Fixed, int> top = candidates.pop();
+    topPriority.clear();
+    topPriority.push_back(slots[top.second]);
+    topKeys.clear();
+    topKeys.push_back(top.first);
+    while (!candidates.empty()) {
+        pair<Fixed, int> next = candidates.pop();
+        topPriority.push_back(slots[next.second]);
+        topKeys.push_back(next.first);
+        if (next.first < top.first) {
+            break;
+        }
+    }
+    // the last one popped is lower unless the heap ran out
+    size_t numTied = topPriority.size();
+    if (topKeys.back() < top.first) {
+        numTied--;
+    }
+
+    int mostAvailability = INT_MIN;
+    size_t indexMostAvailability = 0;
+    for (size_t j = 0; j < numTied; j++) {
+        int currAvailability 
+                = topPriority[j]->getParent()->getShiftsRemaining();
+        if (currAvailability > mostAvailability) {
+            mostAvailability = currAvailability;
+            indexMostAvailability = j;
+        }
+    }
+
+    for (size_t j = 0; j < topPriority.size(); j++) {
+        if (j != indexMostAvailability) {
+            candidates.push(topPriority[j]->getId(), topKeys[j]);
+        }
+    }
+    return topPriority[indexMostAvailability];
 }
 
 
@@ -152,18 +543,27 @@ void Scheduler::graphBalance() {
 
     // loops until all workers are evenly allocated
     while (abs(max->getRelativeBooking() - min->getRelativeBooking()) > 1) {
-        WorkerNode *currWorker = max;
-
-        // try to find path
-        bool madeChange = searchWorker(currWorker);
-
-        // if a path was found, the graph is changed and other nodes for 
-        // which a path didn't exist might exist now
-        if (madeChange) {
-            resetNoPath();
+        if (balanceIterations % CHECKPOINT_INTERVAL == 0 and !checkpoint()) {
+            abandoned = true;
+            return;
+        }
+        balanceIterations++;
+        if (batchBalance) {
+            balanceBatch(min);
         } else {
-            cerr << "didn't find a path" << endl; // todo: debugging
-            currWorker->setNoPath(true);
+            WorkerNode *currWorker = max;
+
+            // try to find path
+            bool madeChange = searchWorker(currWorker);
+
+            // if a path was found, the graph is changed and other nodes for 
+            // which a path didn't exist might exist now
+            if (madeChange) {
+                resetNoPath();
+            } else {
+                cerr << "didn't find a path" << endl; // todo: debugging
+                currWorker->setNoPath(true);
+            }
         }
 
         if (!findMinMaxWorkerBooking(&min, &max)) {  // no more workers that are unmarked
@@ -173,6 +573,94 @@ void Scheduler::graphBalance() {
     }
 }
 
+// scores the schedule so far without the range, which graphBalance brings
+// down to at most one. Returns false if the pruner finds the seed hopeless
+bool Scheduler::checkpoint() {
+    if (pruner == nullptr or !pruner->isEnabled()) {
+        return true;
+    }
+
+    int mostIndex;
+    int leastIndex;
+    double leastPriority;
+    double mostPriority;
+    double average = findAverage(leastIndex, mostIndex, leastPriority, mostPriority);
+    const ScoreWeights &weights = inputData.getWeights();
+    double score = weights.getAverageProportion() * average 
+                   + weights.getLowestProportion() * leastPriority;
+    size_t index = checkpointScores.size();
+    if (index < SeedPruner::MAX_CHECKPOINTS) {
+        checkpointScores.push_back(score);
+    }
+    return !pruner->hopeless(index, score);
+}
+
+// One round in the style of Hopcroft-Karp: the overbooked workers are taken
+// from most overbooked down, and each one's search leaves out the workers
+// already on a path this round. The paths share no workers, so none of them
+// changes the used slots or bookings another one relied on, and priorities
+// are only updated and bookings only scanned again once per round.
+void Scheduler::balanceBatch(WorkerNode *min) {
+    collectOverbooked(min->getRelativeBooking());
+    lockRound++;
+
+    bool madeChange = false;
+    for (size_t i = 0; i < batchWorkers.size(); i++) {
+        if (workerLock[batchWorkers[i]->getId()] == lockRound) {
+            continue;  // already moved by a path this round
+        }
+
+        if (findWorkerPath(batchWorkers[i], bestPath)) {
+            lockPathWorkers(bestPath);
+            applyPath(bestPath);
+            madeChange = true;
+        }
+    }
+
+    // same as one path at a time: a change might open paths for anyone,
+    // otherwise nothing was locked and none of these workers have a path
+    if (madeChange) {
+        resetAllMemoizedPriorities();
+        resetNoPath();
+    } else {
+        cerr << "didn't find a path" << endl; // todo: debugging
+        for (size_t i = 0; i < batchWorkers.size(); i++) {
+            batchWorkers[i]->setNoPath(true);
+        }
+    }
+}
+
+// searchable workers that are more than one shift above the least booked
+void Scheduler::collectOverbooked(int minBooking) {
+    batchWorkers.clear();
+    int n = inputData.getNumWorkers();
+    for (int i = 0; i < n; i++) {
+        WorkerNode *currWorker = inputData.getWorker(i);
+        if (!currWorker->getNoPath() and 
+            currWorker->getRelativeBooking() - minBooking > 1) {
+            batchWorkers.push_back(currWorker);
+        }
+    }
+    sort(batchWorkers.begin(), batchWorkers.end(), moreOverbooked);
+}
+
+bool Scheduler::moreOverbooked(WorkerNode *w1, WorkerNode *w2) {
+    return w1->getRelativeBooking() > w2->getRelativeBooking() or
+           (w1->getRelativeBooking() == w2->getRelativeBooking() and 
+            w1->getId() < w2->getId());
+}
+
+void Scheduler::lockPathWorkers(const vector<TimeSlotNode *> &path) {
+    for (size_t i = 0; i < path.size(); i++) {
+        workerLock[path[i]->getParent()->getId()] = lockRound;
+    }
+}
+
+// only balanceBatch locks workers
+bool Scheduler::locked(WorkerNode *worker) const {
+    return batchBalance and workerLock[worker->getId()] == lockRound;
+}
+
 // finds the workers with the highest and lowest booking
 bool Scheduler::findMinMaxWorkerBooking(WorkerNode **min, WorkerNode **max) {
     int n = inputData.getNumWorkers();
@@ -199,65 +687,136 @@ bool Scheduler::findMinMaxWorkerBooking(WorkerNode **min, WorkerNode **max) {
 
 // takes a worker, and calls findPath to graph search to remove an allocations
 bool Scheduler::searchWorker(WorkerNode *currWorker) {
-    double bestPathVal;
-    bool foundPath = false;
-    const vector<TimeSlotNode *> &blocks = currWorker->getAllocations();
-    vector<TimeSlotNode *> bestPath;
-    for (auto it = blocks.begin(); it != blocks.end(); it++) {
-        pair<double, TimeSlotNode *> result = findPath(*it);
-        if (result.second != nullptr and (!foundPath or result.first > bestPathVal)) {
-            bestPathVal = result.first;
-            buildPath(bestPath, result.second);
-            foundPath = true;
-        }
-    }
-
+    bool foundPath = findWorkerPath(currWorker, bestPath);
     if (foundPath) {
         makeChanges(bestPath);
     }
     return foundPath;
 }
 
-void Scheduler::resetSearchValues() {
-    int n = inputData.getNumWorkers();
-    for (int i = 0; i < n; i++) {
-        const vector<TimeSlotNode *> &slots = inputData.getWorker(i)->getAvailability();
-        for (size_t j = 0; j < slots.size(); j++) {
-            slots[j]->setSeen(false);
-            slots[j]->setPrev(nullptr);
+// finds the best path starting from any allocation of currWorker. The
+// searches from each allocation only read the schedule, so they run in
+// parallel when there is a thread pool
+bool Scheduler::findWorkerPath(WorkerNode *currWorker,
+                               vector<TimeSlotNode *> &path) {
+    const vector<TimeSlotNode *> &blocks = currWorker->getAllocations();
+    for (size_t i = 0; i < scratches.size(); i++) {
+        scratches[i].foundPath = false;
+        scratches[i].searched.reset();
+    }
+
+    auto search = [&](int index, int thread) {
+        searchBlock(blocks[index], index, scratches[thread]);
+    };
+    if (pool != nullptr) {
+        pool->parallelFor(blocks.size(), search);
+    } else {
+        for (size_t i = 0; i < blocks.size(); i++) {
+            search(i, 0);
+        }
+    }
+
+    // best of each thread's best. Ties go to the earliest allocation, which
+    // is the path a search in order would have kept
+    SearchScratch *best = nullptr;
+    for (size_t i = 0; i < scratches.size(); i++) {
+        SearchScratch &curr = scratches[i];
+        if (curr.foundPath and 
+            (best == nullptr or curr.bestPathVal > best->bestPathVal or
+             (curr.bestPathVal == best->bestPathVal and 
+              curr.bestBlock < best->bestBlock))) {
+            best = &curr;
         }
     }
+
+    ColumnMask &searched = searchedColumns[currWorker->getId()];
+    searched.reset();
+    for (size_t i = 0; i < scratches.size(); i++) {
+        searched |= scratches[i].searched;
+    }
+
+    if (best != nullptr) {
+        path = best->bestPath;
+    }
+    return best != nullptr;
 }
 
+// searches from one allocation, keeping the path if it is the best this
+// thread has found so far. Each thread takes allocations in increasing order
+void Scheduler::searchBlock(TimeSlotNode *block, size_t blockIndex,
+                            SearchScratch &scratch) {
+    if (block->getForced()) {  // its shift has nobody to replace it
+        return;
+    }
+
+    pair<Fixed, TimeSlotNode *> result = findPath(block, scratch);
+    if (result.second != nullptr and 
+        (!scratch.foundPath or result.first > scratch.bestPathVal)) {
+        scratch.bestPathVal = result.first;
+        scratch.bestBlock = blockIndex;
+        buildPath(scratch.bestPath, result.second, scratch);
+        scratch.foundPath = true;
+    }
+}
+
+// only the slots the last search marked need to be cleared
+void Scheduler::resetSearchValues(SearchScratch &scratch) {
+    for (size_t i = 0; i < scratch.touched.size(); i++) {
+        scratch.seen[scratch.touched[i]] = false;
+        scratch.prev[scratch.touched[i]] = -1;
+    }
+    scratch.touched.clear();
+    scratch.paths.clear();
+}
+
+void Scheduler::markSeen(TimeSlotNode *slot, TimeSlotNode *prev,
+                         SearchScratch &scratch) {
+    int id = slot->getId();
+    scratch.prev[id] = (prev == nullptr) ? -1 : prev->getId();
+    scratch.seen[id] = true;
+    scratch.touched.push_back(id);
+}
+
+// only workers whose failed search read a shift changed since then can
+// have a path now
 void Scheduler::resetNoPath() {
     int n = inputData.getNumWorkers();
     for (int i = 0; i < n; i++) {
-        inputData.getWorker(i)->setNoPath(false);
+        if ((searchedColumns[i] & changedColumns).any()) {
+            inputData.getWorker(i)->setNoPath(false);
+        }
     }
+    changedColumns.reset();
 }
 
-pair<double, TimeSlotNode *> Scheduler::findPath(TimeSlotNode *overbooked) {
-    resetSearchValues();
+int Scheduler::column(const TimeSlotNode *slot) {
+    return slot->getDay() * MAX_SHIFTS + slot->getShift();
+}
+
+pair<Fixed, TimeSlotNode *> Scheduler::findPath(TimeSlotNode *overbooked,
+                                                 SearchScratch &scratch) {
+    resetSearchValues(scratch);
 
-    priority_queue<pair<double, TimeSlotNode *>> paths;
-    paths.push({-overbooked->getMemoizedPriority(false), overbooked});
-    overbooked->setSeen(true);
+    const vector<TimeSlotNode *> &slots = inputData.getSlotList();
+    IndexedHeap &paths = scratch.paths;
+    paths.push(overbooked->getId(), -overbooked->getMemoizedPriority(false));
+    markSeen(overbooked, nullptr, scratch);
 
-    // double is the value of the current path, and the timeslotnode is the 
+    // Fixed is the value of the current path, and the timeslotnode is the 
     // next node to drop from allocations
-    pair<double, TimeSlotNode *> bestPath = {0, nullptr};
+    pair<Fixed, TimeSlotNode *> bestPathEnd = {0, nullptr};
     while(!paths.empty()) {
-        pair<double, TimeSlotNode *> currPath = paths.top();
-        paths.pop();
+        pair<Fixed, int> top = paths.pop();
+        pair<Fixed, TimeSlotNode *> currPath = {top.first, slots[top.second]};
 
         // trying to find a timeslotnode that can replace the current node
-        findNodeToAdd(paths, bestPath, currPath, overbooked);
+        findNodeToAdd(bestPathEnd, currPath, overbooked, scratch);
     }
 
-    return bestPath;
+    return bestPathEnd;
 }
 
-void Scheduler::findNodeToAdd(priority_queue<pair<double, TimeSlotNode *>> &paths, pair<double, TimeSlotNode *> &bestPath, pair<double, TimeSlotNode *> currPath, TimeSlotNode *start) {
+void Scheduler::findNodeToAdd(pair<Fixed, TimeSlotNode *> &bestPathEnd, pair<Fixed, TimeSlotNode *> currPath, TimeSlotNode *start, SearchScratch &scratch) {
     TimeSlotNode *initial = currPath.second;
 
     // populates neighbors of current node
@@ -265,56 +824,64 @@ void Scheduler::findNodeToAdd(priority_queue<pair<double, TimeSlotNode *>> &path
     // replace the current shift.
     int day = initial->getDay(), shift = initial->getShift();
     const vector<TimeSlotNode *> &neighbors = inputData.getWorkersAvailable(day, shift);
+    scratch.searched.set(column(initial));
 
     // don't want to change the booking of the neighbor, so find another 
     //shift they are on and remove it.
     for (size_t i = 0; i < neighbors.size(); i++) {
         // not already on a path, and a possible replacement for initial
-        if (!neighbors[i]->getSeen() && !neighbors[i]->getUsed()) {
-            neighbors[i]->setPrev(currPath.second);
-            neighbors[i]->setSeen(true);
+        if (!scratch.seen[neighbors[i]->getId()] && !neighbors[i]->getUsed() &&
+            !locked(neighbors[i]->getParent())) {
+            markSeen(neighbors[i], currPath.second, scratch);
 
             // check to see if at the end of a valid path
             if (validPath(start, neighbors[i])) {
-                double pathValue = currPath.first + neighbors[i]->getMemoizedPriority(false);
-                if (bestPath.second == nullptr or pathValue > bestPath.first) {
-                    bestPath = {pathValue, neighbors[i]};
+                Fixed pathValue = currPath.first + neighbors[i]->getMemoizedPriority(false);
+                if (bestPathEnd.second == nullptr or pathValue > bestPathEnd.first) {
+                    bestPathEnd = {pathValue, neighbors[i]};
                 }
             }
 
             // shift to remove from the same person to balance shift numbers
-            findNodeToDrop(paths, neighbors[i], currPath.first);
+            findNodeToDrop(neighbors[i], currPath.first, scratch);
         }
     }
 }
 
-void Scheduler::findNodeToDrop(priority_queue<pair<double, TimeSlotNode *>> &paths, TimeSlotNode *neighbor, double currPathValue) {
+void Scheduler::findNodeToDrop(TimeSlotNode *neighbor, Fixed currPathValue, SearchScratch &scratch) {
     // the pool for allocations is different from the pool for neighbors, so 
     // all nodes in allocations is a potential replacement
     const vector<TimeSlotNode *> &allocations = neighbor->getParent()->getAllocations();
     for (size_t j = 0; j < allocations.size(); j++) {
-        // shift has to already be used, and cannot be in another path
-        if (!allocations[j]->getSeen()) {
-            allocations[j]->setPrev(neighbor); // maintain the path
-            allocations[j]->setSeen(true);
-            double newValue = currPathValue + neighbor->getMemoizedPriority(false) - allocations[j]->getMemoizedPriority(false);
-            paths.push({newValue, allocations[j]});
+        // shift has to already be used, and cannot be in another path. The
+        // first path to reach a shift keeps it, re-keying it when a better
+        // path shows up made no better schedules and was slower
+        if (!scratch.seen[allocations[j]->getId()] and 
+            !allocations[j]->getForced()) {
+            markSeen(allocations[j], neighbor, scratch); // maintain the path
+            Fixed newValue = currPathValue + neighbor->getMemoizedPriority(false) - allocations[j]->getMemoizedPriority(false);
+            scratch.paths.push(allocations[j]->getId(), newValue);
         }
     }
 }
 
+// the path moves a shift from start's worker to end's worker, so end has to be
+// booked at least two less. Allowing the other direction let a path load a
+// worker already marked noPath, and on sparse rosters balancing never ended
 bool Scheduler::validPath(TimeSlotNode *start, TimeSlotNode *end) {
-    return abs(start->getParent()->getRelativeBooking() - end->getParent()->getRelativeBooking()) > 1;
+    return start->getParent()->getRelativeBooking() - end->getParent()->getRelativeBooking() > 1;
 }
 
 
-void Scheduler::buildPath(vector<TimeSlotNode *> &path, TimeSlotNode *end) {
+void Scheduler::buildPath(vector<TimeSlotNode *> &path, TimeSlotNode *end,
+                          SearchScratch &scratch) {
     path.clear();
 
-    TimeSlotNode *curr = end;
-    while (curr != nullptr) {
-        path.push_back(curr);
-        curr = curr->getPrev();
+    const vector<TimeSlotNode *> &slots = inputData.getSlotList();
+    int curr = end->getId();
+    while (curr != -1) {
+        path.push_back(slots[curr]);
+        curr = scratch.prev[curr];
     }
     reverse(path.begin(), path.end());
 }
@@ -324,8 +891,15 @@ void Scheduler::buildPath(vector<TimeSlotNode *> &path, TimeSlotNode *end) {
 // path goes allocated -> not allocated -> allocated -> etc. (ends on not
 //      allocated)
 void Scheduler::makeChanges(vector<TimeSlotNode *> &path) {
+    applyPath(path);
+    resetAllMemoizedPriorities();
+}
+
+// same as makeChanges, without updating the memoized priorities
+void Scheduler::applyPath(vector<TimeSlotNode *> &path) {
     bool allocated = true;
     for (auto it = path.begin(); it != path.end(); it++) {
+        changedColumns |= availableColumns[(*it)->getParent()->getId()];
         if (allocated) {
             removeAllocation(*it);
         } else {
@@ -334,7 +908,6 @@ void Scheduler::makeChanges(vector<TimeSlotNode *> &path) {
 
         allocated = !allocated;
     }
-    resetAllMemoizedPriorities();
 }
 
 void Scheduler::resetAllMemoizedPriorities() {
@@ -347,14 +920,292 @@ void Scheduler::resetAllMemoizedPriorities() {
     }
 }
 
+/********************************* Refinement *********************************/
+
+// large neighborhood search on a finished schedule. Each iteration empties
+// the shifts of one neighborhood (a day, one shift time across the week, or
+// a worker and the coworkers they like), fills them again with initialOneSlot
+// in a shuffled order, and balances. Only the emptied shifts are refilled and
+// balancing starts from a schedule that is balanced everywhere else, so an
+// iteration costs far less than a new seed.
+// noPath marks are cleared for scoring, so the range is over every worker.
+// Even bookings come before happiness: a result is kept if its range is
+// lower, or the same and its score did not go down. Otherwise the journal of
+// changes is undone
+void Scheduler::refine(int iterations) {
+    if (!calculated) {
+        throw runtime_error("Error: tried to refine before calculating");
+    }
+    auto start = chrono::steady_clock::now();
+
+    SeedPruner *savedPruner = pruner;  // no checkpoints after the sweep
+    pruner = nullptr;
+    clearNoPath();
+    double score = getScore();
+    int range = getRange();
+    refineStats = RefineStats();
+    refineStats.startScore = score;
+
+    for (int i = 0; i < iterations; i++) {
+        uint64_t stream = REFINE_STREAM + i;
+        Neighborhood kind = (Neighborhood) rng.belowAt(stream, 0, NUM_NEIGHBORHOODS);
+        refineStats.tried[kind]++;
+
+        journal.clear();
+        journaling = true;
+        destroyNeighborhood(kind, stream);
+        repairNeighborhood(stream);
+        graphBalance();
+        journaling = false;
+        clearNoPath();
+
+        double newScore = getScore();
+        int newRange = getRange();
+        if (newRange < range or (newRange == range and newScore > score)) {
+            refineStats.improved[kind]++;
+        } else if (newRange == range and newScore == score) {
+            refineStats.kept[kind]++;
+        } else {
+            undoJournal();
+            continue;
+        }
+        score = newScore;
+        range = newRange;
+    }
+
+    pruner = savedPruner;
+    refineStats.endScore = score;
+    chrono::duration<double> seconds = chrono::steady_clock::now() - start;
+    refineStats.seconds = seconds.count();
+    validateSolution();
+}
+
+// takes out every allocation of the neighborhood, marking the shifts to fill
+void Scheduler::destroyNeighborhood(Neighborhood kind, uint64_t stream) {
+    refineShifts.clear();
+    switch (kind) {
+    case DAY: {
+        int day = rng.belowAt(stream, 1, NUM_DAYS);
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            emptyShift(day, j);
+        }
+        break;
+    }
+    case COLUMN: {
+        int shift = rng.belowAt(stream, 1, MAX_SHIFTS);
+        for (int i = 0; i < NUM_DAYS; i++) {
+            emptyShift(i, shift);
+        }
+        break;
+    }
+    case COWORKERS: {
+        WorkerNode *worker = inputData.getWorker(
+            rng.belowAt(stream, 1, inputData.getNumWorkers()));
+        workerOrder.clear();
+        workerOrder.push_back(worker);
+        const unordered_set<WorkerNode *> &likes = worker->getLikedCoworkers();
+        workerOrder.insert(workerOrder.end(), likes.begin(), likes.end());
+
+        for (size_t i = 0; i < workerOrder.size(); i++) {
+            const vector<TimeSlotNode *> &allocations = workerOrder[i]->getAllocations();
+            while (!allocations.empty()) {
+                TimeSlotNode *slot = allocations.back();
+                int index = column(slot);
+                if (!shiftEmptied[index]) {
+                    shiftEmptied[index] = true;
+                    refineShifts.push_back(index);
+                }
+                removeAllocation(slot);
+            }
+        }
+        break;
+    }
+    default:
+        throw runtime_error("Error: unknown neighborhood");
+    }
+}
+
+void Scheduler::emptyShift(int day, int shift) {
+    vector<TimeSlotNode *> &onShift = finalSchedule[day][shift];
+    if (onShift.empty()) {
+        return;
+    }
+
+    while (!onShift.empty()) {
+        removeAllocation(onShift.back());
+    }
+    shiftEmptied[day * MAX_SHIFTS + shift] = true;
+    refineShifts.push_back(day * MAX_SHIFTS + shift);
+}
+
+// fills the emptied shifts again, in an order that depends on the iteration.
+// Likes are unordered, so the shifts are sorted before the shuffle
+void Scheduler::repairNeighborhood(uint64_t stream) {
+    sort(refineShifts.begin(), refineShifts.end());
+    rng.shuffle(refineShifts, stream);
+    for (size_t i = 0; i < refineShifts.size(); i++) {
+        int day = refineShifts[i] / MAX_SHIFTS;
+        int shift = refineShifts[i] % MAX_SHIFTS;
+        initialOneSlot(inputData.getWorkersAvailable(day, shift));
+        shiftEmptied[refineShifts[i]] = false;
+    }
+}
+
+// path relinking from the current, finished schedule towards guide, another
+// finished schedule given by slot ids. Each step swaps, within one shift, an
+// allocation guide does not have for one it has, taking the swap that gains
+// the most priority. Staffing stays right, but bookings drift until guide is
+// reached, so every schedule on the way is balanced under the journal,
+// scored, and undone. The best of them goes in best if it beats best's
+// score; returns whether one did. The schedule ends at guide
+bool Scheduler::relink(const vector<int> &guide, EliteSchedule &best) {
+    if (!calculated) {
+        throw runtime_error("Error: tried to relink before calculating");
+    }
+
+    const vector<TimeSlotNode *> &slots = inputData.getSlotList();
+    for (size_t i = 0; i < guideShifts.size(); i++) {
+        guideShifts[i].clear();
+    }
+    for (size_t i = 0; i < guide.size(); i++) {
+        inGuide[guide[i]] = true;
+        guideShifts[column(slots[guide[i]])].push_back(slots[guide[i]]);
+    }
+
+    SeedPruner *savedPruner = pruner;
+    pruner = nullptr;
+    bool foundBetter = false;
+    TimeSlotNode *out;
+    TimeSlotNode *in;
+    while (nextRelinkSwap(&out, &in)) {
+        removeAllocation(out);
+        addAllocation(in);
+
+        TimeSlotNode *ignoredOut;
+        TimeSlotNode *ignoredIn;
+        if (!nextRelinkSwap(&ignoredOut, &ignoredIn)) {
+            break;  // at guide, which is already known
+        }
+
+        journal.clear();
+        journaling = true;
+        clearNoPath();
+        graphBalance();
+        journaling = false;
+
+        double score = getScore();
+        if (score > best.score) {
+            snapshot(best, score);
+            foundBetter = true;
+        }
+        undoJournal();
+    }
+    pruner = savedPruner;
+    clearNoPath();
+
+    for (size_t i = 0; i < guide.size(); i++) {
+        inGuide[guide[i]] = false;
+    }
+    return foundBetter;
+}
+
+// the swap with the largest gain of priority, false once the schedule is guide
+bool Scheduler::nextRelinkSwap(TimeSlotNode **out, TimeSlotNode **in) {
+    bool found = false;
+    Fixed bestGain = 0;
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            const vector<TimeSlotNode *> &onShift = finalSchedule[i][j];
+            const vector<TimeSlotNode *> &guided = guideShifts[i * MAX_SHIFTS + j];
+            for (size_t k = 0; k < onShift.size(); k++) {
+                if (inGuide[onShift[k]->getId()]) {
+                    continue;
+                }
+                Fixed lost = onShift[k]->getPriority(finalSchedule, true);
+                for (size_t l = 0; l < guided.size(); l++) {
+                    if (guided[l]->getUsed()) {
+                        continue;
+                    }
+                    Fixed gain = guided[l]->getPriority(finalSchedule, true) - lost;
+                    if (!found or gain > bestGain) {
+                        found = true;
+                        bestGain = gain;
+                        *out = onShift[k];
+                        *in = guided[l];
+                    }
+                }
+            }
+        }
+    }
+    return found;
+}
+
+// copies the schedule out, e.g. for an ElitePool
+void Scheduler::snapshot(EliteSchedule &out, double score) const {
+    out.score = score;
+    out.seed = seed;
+    out.perturbation = getPerturbation();
+    out.hash = stateHash;
+    out.slotIds.clear();
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            for (size_t k = 0; k < finalSchedule[i][j].size(); k++) {
+                out.slotIds.push_back(finalSchedule[i][j][k]->getId());
+            }
+        }
+    }
+    sort(out.slotIds.begin(), out.slotIds.end());
+}
+
+// takes back every change of the iteration, latest first
+void Scheduler::undoJournal() {
+    for (size_t i = journal.size(); i > 0; i--) {
+        if (journal[i - 1].second) {
+            removeAllocation(journal[i - 1].first);
+        } else {
+            addAllocation(journal[i - 1].first);
+        }
+    }
+    journal.clear();
+}
+
+void Scheduler::clearNoPath() {
+    int n = inputData.getNumWorkers();
+    for (int i = 0; i < n; i++) {
+        inputData.getWorker(i)->setNoPath(false);
+    }
+    changedColumns.reset();
+}
+
+string Scheduler::neighborhoodName(Neighborhood kind) {
+    switch (kind) {
+    case DAY:
+        return "day";
+    case COLUMN:
+        return "shift time";
+    case COWORKERS:
+        return "coworkers";
+    default:
+        return "unknown";
+    }
+}
+
 /********************************* Validation *********************************/
 
 // validate that a solution works, i.e. all shifts have correct number of workers,
-// as well as under the hood problems like values of used and seen
+// as well as under the hood problems like values of used and allocations
 void Scheduler::validateSolution() {
+    if (validation == Validation::OFF) {
+        return;
+    }
+
     validateWorkersOnShift();
     validateNoDuplicateWorkers();
     validateUsed();
+    if (validation == Validation::FULL) {
+        validateWorkers();
+        validateStateHash();
+    }
 }
 
 void Scheduler::validateWorkersOnShift() {
@@ -371,34 +1222,39 @@ void Scheduler::validateWorkersOnShift() {
     }
 }
 
+// no duplicate workers on same shift. Each shift stamps the ids of its
+// workers with its own number, so a repeat shows up as an id already stamped
 void Scheduler::validateNoDuplicateWorkers() {
+    unsigned int stamp = 0;
     for (int i = 0; i < NUM_DAYS; i++) {
         for (int j = 0; j < MAX_SHIFTS; j++) {
-            // no duplicate workers on same shift
-            unordered_set<string> namesSoFar;
-            for (auto it = finalSchedule[i][j].begin();
-                 it != finalSchedule[i][j].end(); it++) {
-                string name = (*it)->getParent()->getName();
-                if (namesSoFar.find(name) != namesSoFar.end()) {
-                    string message =
-                        "Error: " + name + " is on " +
+            stamp++;
+            const vector<TimeSlotNode *> &onShift = finalSchedule[i][j];
+            for (size_t k = 0; k < onShift.size(); k++) {
+                WorkerNode *worker = onShift[k]->getParent();
+                if (workerStamps[worker->getId()] == stamp) {
+                    string message = 
+                        "Error: " + worker->getName() + " is on " + 
                         dayNames[i] + " " + shiftNames[j] + " more than once";
                     throw runtime_error(message);
                 }
-                namesSoFar.insert(name);
+                workerStamps[worker->getId()] = stamp;
             }
         }
     }
+
+    // stamps start over next seed
+    fill(workerStamps.begin(), workerStamps.end(), 0);
 }
 
 void Scheduler::validateUsed() {
     for (int i = 0; i < NUM_DAYS; i++) {
         for (int j = 0; j < MAX_SHIFTS; j++) {
-            // no duplicate workers on same shift
-            unordered_set<string> namesSoFar;
+            // every worker on shift is marked as used, on this shift
             for (auto it = finalSchedule[i][j].begin();
                  it != finalSchedule[i][j].end(); it++) {
-                if (!(*it)->getUsed()) {
+                if (!(*it)->getUsed() or (*it)->getDay() != i or 
+                    (*it)->getShift() != j) {
                     string name = (*it)->getParent()->getName();
                     string message = "Error: " + name + ", with block" 
                                      + to_string((*it)->getDay()) + " : " 
@@ -411,6 +1267,79 @@ void Scheduler::validateUsed() {
     }
 }
 
+// every worker's allocations are exactly their used slots, and their
+// booking counters agree with how many there are
+void Scheduler::validateWorkers() {
+    int totalUsed = 0;
+    int n = inputData.getNumWorkers();
+    for (int i = 0; i < n; i++) {
+        WorkerNode *worker = inputData.getWorker(i);
+        const vector<TimeSlotNode *> &allocations = worker->getAllocations();
+        const vector<TimeSlotNode *> &available = worker->getAvailability();
+
+        int used = 0;
+        for (size_t j = 0; j < available.size(); j++) {
+            if (available[j]->getUsed()) {
+                used++;
+            }
+        }
+        for (size_t j = 0; j < allocations.size(); j++) {
+            if (allocations[j]->getParent() != worker or 
+                !allocations[j]->getUsed()) {
+                throw runtime_error("Error: " + worker->getName() + 
+                                    " has an allocation that is not theirs "
+                                    "or not marked as used");
+            }
+        }
+
+        int allocated = allocations.size();
+        if (used != allocated) {
+            throw runtime_error("Error: " + worker->getName() + " has " + 
+                                to_string(used) + " used slots but " + 
+                                to_string(allocated) + " allocations");
+        }
+        if (worker->getRelativeBooking() != allocated - worker->getMaxShifts() or
+            worker->getShiftsRemaining() != worker->getMaxShifts() - allocated) {
+            throw runtime_error("Error: booking of " + worker->getName() + 
+                                " does not match their allocations");
+        }
+        totalUsed += used;
+    }
+
+    // with the per shift checks, this means every used slot is on its shift
+    int totalOnShifts = 0;
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            totalOnShifts += finalSchedule[i][j].size();
+        }
+    }
+    if (totalUsed != totalOnShifts) {
+        throw runtime_error("Error: " + to_string(totalUsed) + 
+                            " slots are used but " + to_string(totalOnShifts) + 
+                            " are on shifts");
+    }
+}
+
+// the incrementally kept hash matches the one of the final schedule
+void Scheduler::validateStateHash() {
+    vector<uint64_t> hashes(inputData.getNumWorkers(), 0);
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            for (size_t k = 0; k < finalSchedule[i][j].size(); k++) {
+                TimeSlotNode *slot = finalSchedule[i][j][k];
+                hashes[slot->getParent()->getId()] ^= slotKeys[slot->getId()];
+            }
+        }
+    }
+    uint64_t hash = 0;
+    for (size_t i = 0; i < hashes.size(); i++) {
+        hash += CounterRandom::mix(hashes[i]);
+    }
+    if (hash != stateHash or hashes != workerHashes) {
+        throw runtime_error("Error: state hash does not match the schedule");
+    }
+}
+
 /********************************* Statistics *********************************/
 
 double Scheduler::getAverage() {
@@ -434,7 +1363,9 @@ int Scheduler::getRange() {
 
     WorkerNode *min;
     WorkerNode *max;
-    findMinMaxWorkerBooking(&min, &max);
+    if (!findMinMaxWorkerBooking(&min, &max)) {
+        return 0;  // graphBalance gave up on every worker
+    }
 
     return (max->getRelativeBooking() - min->getRelativeBooking());
 }
@@ -453,28 +1384,89 @@ double Scheduler::getLeastHappy() {
     return leastPriority;
 }
 
+// combines the statistics according to the proportions of the input, by
+// default the ones in ScheduleData.h
+double Scheduler::getScore() {
+    const ScoreWeights &weights = inputData.getWeights();
+    return (weights.getAverageProportion() * getAverage()) 
+           + (weights.getLowestProportion() * getLeastHappy()) 
+           + (weights.getRangeProportion() * getRange());
+}
+
+Construction Scheduler::getConstruction() const {
+    return construction;
+}
+
+Perturbation Scheduler::getPerturbation() const {
+    Perturbation perturbation;
+    perturbation.construction = construction;
+    perturbation.noiseDivisor = noiseDivisor;
+    return perturbation;
+}
+
+// Zobrist hash of which slots are allocated: the xor of their keys
+uint64_t Scheduler::getStateHash() const {
+    return stateHash;
+}
+
+unsigned int Scheduler::getSeed() const {
+    return seed;
+}
+
+int Scheduler::getBalanceIterations() const {
+    return balanceIterations;
+}
+
+bool Scheduler::getAbandoned() const {
+    return abandoned;
+}
+
+// only the first SeedPruner::MAX_CHECKPOINTS are kept
+const vector<double> &Scheduler::getCheckpointScores() const {
+    return checkpointScores;
+}
+
+const vector<vector<vector<TimeSlotNode *>>> &Scheduler::getFinalSchedule() const {
+    return finalSchedule;
+}
+
 // TODO: split the finding of the least and most happy worker into seperate 
 // functions from finding the average?
 double Scheduler::findAverage(int &leastIndex, int &mostIndex,
                               double &leastPriority, double &mostPriority) {
-    double totalPriority = 0;
-    int totalShifts = 0;
-    bool firstWorker = true;
+    // every allocation's priority in one array, summed per worker by the
+    // kernel. Sums are exact, only the averages are rounded
     int n = inputData.getNumWorkers();
+    allocationValues.clear();
     for (int i = 0; i < n; i++) {
-        double currPriority = 0;
-        WorkerNode *currWorker = inputData.getWorker(i);
-        for (auto shift = currWorker->getAllocations().begin();
-             shift != currWorker->getAllocations().end(); shift++) {
-            currPriority += (*shift)->getPriority(finalSchedule, true);
+        allocationOffsets[i] = allocationValues.size();
+        const vector<TimeSlotNode *> &allocations = 
+            inputData.getWorker(i)->getAllocations();
+        for (size_t j = 0; j < allocations.size(); j++) {
+            allocationValues.push_back(allocations[j]->getPriority(finalSchedule, true));
         }
+    }
+    allocationOffsets[n] = allocationValues.size();
+    PriorityKernels::segmentSums(allocationValues.data(), allocationOffsets.data(),
+                                 n, workerSums.data());
 
-        int currShifts =  currWorker->getAllocations().size();
+    Fixed totalPriority = 0;
+    int totalShifts = 0;
+    bool firstWorker = true;
+    leastIndex = mostIndex = 0;
+    leastPriority = mostPriority = 0;
+    for (int i = 0; i < n; i++) {
+        Fixed currPriority = workerSums[i];
+        int currShifts = allocationOffsets[i + 1] - allocationOffsets[i];
         // for calculating overall averages
         totalPriority += currPriority;
         totalShifts += currShifts;
 
-        double currAverage = currPriority / (double) currShifts;
+        // a worker without shifts has no average, and would make it NaN
+        if (currShifts == 0) {
+            continue;
+        }
+        double currAverage = fromFixed(currPriority) / (double) currShifts;
 
         // finding the most and least happy worker
         if (firstWorker or currAverage < leastPriority) {
@@ -489,7 +1481,7 @@ double Scheduler::findAverage(int &leastIndex, int &mostIndex,
         firstWorker = false;
     }
     // return average happiness across all workers
-    return totalPriority / (double)totalShifts;
+    return fromFixed(totalPriority) / (double)totalShifts;
 }
 
 /********************************** Printing **********************************/
@@ -499,7 +1491,12 @@ double Scheduler::findAverage(int &leastIndex, int &mostIndex,
 // most satisfied worker
 // least satisfied worker
 void Scheduler::printStats(ostream &output) {
-    output << "Stats (seed = " << seed << "):" << endl;
+    output << "Stats (seed = " << seed << ", construction = " 
+           << constructionName(construction);
+    if (noiseDivisor != DEFAULT_NOISE_DIVISOR) {
+        output << ", noise = " << 1 / noiseDivisor;
+    }
+    output << "):" << endl;
     int mostIndex;
     int leastIndex;
     double leastPriority;
@@ -566,3 +1563,18 @@ void Scheduler::printWorkerShiftNum(ostream &output) {
                << " shifts" <<  endl;
     }
 }
+
+void Scheduler::printRefineStats(ostream &output) {
+    int iterations = 0;
+    for (int i = 0; i < NUM_NEIGHBORHOODS; i++) {
+        iterations += refineStats.tried[i];
+    }
+    output << "Refinement: " << iterations << " neighborhoods in " 
+           << refineStats.seconds << " s, score " << refineStats.startScore 
+           << " -> " << refineStats.endScore << endl;
+    for (int i = 0; i < NUM_NEIGHBORHOODS; i++) {
+        output << "    " << neighborhoodName((Neighborhood) i) << ": " 
+               << refineStats.tried[i] << " tried, " << refineStats.improved[i]
+               << " improved, " << refineStats.kept[i] << " the same" << endl;
+    }
+}
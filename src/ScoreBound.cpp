@@ -0,0 +1,178 @@
+#include "ScoreBound.h"
+
+// Every term is bounded on its own, ignoring how the shifts are coupled:
+//     average: every shift is filled, so the total number of shifts is fixed
+//         and the total priority is at most each shift's best candidates
+//     lowest: at most the average, and at most the best shift of any worker
+//         that every schedule has to use
+//     range: graphBalance only stops once the searchable workers are within
+//         one shift of each other
+ScoreBound::ScoreBound(WorkerInputData &data) {
+    boundAverageAndLowest(data);
+    rangeBound = 1;
+
+    // a negative proportion would need a lower bound on its term instead
+    const ScoreWeights &weights = data.getWeights();
+    if (weights.getAverageProportion() < 0 or 
+        weights.getLowestProportion() < 0) {
+        scoreBound = numeric_limits<double>::infinity();
+    } else {
+        scoreBound = weights.getAverageProportion() * averageBound 
+                     + weights.getLowestProportion() * lowestBound 
+                     + max(0.0, weights.getRangeProportion() * rangeBound);
+    }
+}
+
+// the priority of a slot without its penalty, which is never negative, and
+// with a bonus for every liked coworker available that could share the shift
+double ScoreBound::slotBound(TimeSlotNode *slot, WorkerInputData &data) {
+    int day = slot->getDay(), shift = slot->getShift();
+    WorkerNode *worker = slot->getParent();
+    const unordered_set<WorkerNode *> &likes = worker->getLikedCoworkers();
+
+    int coworkers = 0;
+    const vector<TimeSlotNode *> &available = data.getWorkersAvailable(day, shift);
+    for (size_t i = 0; i < available.size(); i++) {
+        WorkerNode *other = available[i]->getParent();
+        if (other != worker and likes.find(other) != likes.end()) {
+            coworkers++;
+        }
+    }
+    coworkers = min(coworkers, data.getWorkersPerShift(day, shift) - 1);
+    if (likes.find(worker) != likes.end()) {
+        coworkers++;  // the worker counts themselves
+    }
+
+    return fromFixed(slot->getTruePriority()) 
+           + coworkers * data.getWeights().getCoworkerBonus();
+}
+
+void ScoreBound::boundAverageAndLowest(WorkerInputData &data) {
+    double totalBound = 0;
+    int totalShifts = 0;
+    lowestBound = numeric_limits<double>::infinity();
+
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            int required = data.getWorkersPerShift(i, j);
+            const vector<TimeSlotNode *> &available = data.getWorkersAvailable(i, j);
+            if (required == 0 or available.empty()) {
+                continue;
+            }
+
+            int taken = min((size_t) required, available.size());
+            totalBound += shiftBound(available, taken, data);
+            totalShifts += taken;
+
+            // no choice in who works this shift
+            if ((int) available.size() <= required) {
+                for (size_t k = 0; k < available.size(); k++) {
+                    const vector<TimeSlotNode *> &slots = 
+                        available[k]->getParent()->getAvailability();
+                    double best = -numeric_limits<double>::infinity();
+                    for (size_t l = 0; l < slots.size(); l++) {
+                        best = max(best, slotBound(slots[l], data));
+                    }
+                    lowestBound = min(lowestBound, best);
+                }
+            }
+        }
+    }
+
+    averageBound = (totalShifts == 0) ? 0 : totalBound / totalShifts;
+    lowestBound = min(lowestBound, averageBound);
+}
+
+// the most total priority the workers of one shift can have. When there are
+// few enough groups of taken workers, all of them are tried with the bonuses
+// inside each group counted exactly. Otherwise each candidate is bounded on
+// their own and the best ones are added up
+double ScoreBound::shiftBound(const vector<TimeSlotNode *> &available,
+                              int taken, WorkerInputData &data) {
+    int numCandidates = available.size();
+    double groups = 1;
+    for (int i = 0; i < taken; i++) {
+        groups = groups * (numCandidates - i) / (i + 1);
+    }
+
+    if (groups > MAX_GROUPS) {
+        vector<double> bounds;
+        for (int i = 0; i < numCandidates; i++) {
+            bounds.push_back(slotBound(available[i], data));
+        }
+        partial_sort(bounds.begin(), bounds.begin() + taken, bounds.end(),
+                     greater<double>());
+        double total = 0;
+        for (int i = 0; i < taken; i++) {
+            total += bounds[i];
+        }
+        return total;
+    }
+
+    GroupSearch search;
+    search.taken = taken;
+    search.best = -numeric_limits<double>::infinity();
+    search.likes.assign(numCandidates * numCandidates, 0);
+    double bonus = data.getWeights().getCoworkerBonus();
+    for (int i = 0; i < numCandidates; i++) {
+        search.priority.push_back(fromFixed(available[i]->getTruePriority()));
+        const unordered_set<WorkerNode *> &likes = 
+            available[i]->getParent()->getLikedCoworkers();
+        for (int j = 0; j < numCandidates; j++) {
+            if (likes.find(available[j]->getParent()) != likes.end()) {
+                search.likes[i * numCandidates + j] = bonus;
+            }
+        }
+    }
+    searchGroups(search, 0, 0);
+    return search.best;
+}
+
+// tries every way to add the rest of the group from candidates >= start
+void ScoreBound::searchGroups(GroupSearch &search, int start, double value) {
+    int numCandidates = search.priority.size();
+    if ((int) search.group.size() == search.taken) {
+        search.best = max(search.best, value);
+        return;
+    }
+
+    for (int i = start; i < numCandidates; i++) {
+        // liking themselves counts too, as it does in calcBonus
+        double added = search.priority[i] + search.likes[i * numCandidates + i];
+        for (size_t j = 0; j < search.group.size(); j++) {
+            int other = search.group[j];
+            added += search.likes[i * numCandidates + other] 
+                     + search.likes[other * numCandidates + i];
+        }
+
+        search.group.push_back(i);
+        searchGroups(search, i + 1, value + added);
+        search.group.pop_back();
+    }
+}
+
+double ScoreBound::getAverageBound() const {
+    return averageBound;
+}
+
+double ScoreBound::getLowestBound() const {
+    return lowestBound;
+}
+
+int ScoreBound::getRangeBound() const {
+    return rangeBound;
+}
+
+double ScoreBound::getScoreBound() const {
+    return scoreBound;
+}
+
+double ScoreBound::gap(double score) const {
+    return scoreBound - score;
+}
+
+void ScoreBound::print(ostream &output) const {
+    output << "Score upper bound: " << scoreBound << " (average <= " 
+           << averageBound << ", lowest <= " << lowestBound << ", range <= " 
+           << rangeBound << ")" << endl;
+}
@@ -0,0 +1,111 @@
+#include "ScoreWeights.h"
+
+static const string weightNames[NUM_WEIGHTS] = {
+    "doubleShiftPenalty", "doubleDayPenalty", "coworkerPreferenceBonus",
+    "averageProportion", "lowestProportion", "overbookedRange"};
+
+static double exponeniatePenalty(int times, double factor, double penalty);
+static array<Fixed, MAX_SHIFTS> penaltyTable(double penalty);
+
+string weightName(Weight weight) {
+    return weightNames[(int) weight];
+}
+
+// returns false if name is not a weight
+bool parseWeight(const string &name, Weight &weight) {
+    for (int i = 0; i < NUM_WEIGHTS; i++) {
+        if (weightNames[i] == name) {
+            weight = (Weight) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+ScoreWeights::ScoreWeights() {
+    values[(int) Weight::DOUBLE_SHIFT_PENALTY] = doubleShiftPenalty;
+    values[(int) Weight::DOUBLE_DAY_PENALTY] = doubleDayPenalty;
+    values[(int) Weight::COWORKER_BONUS] = coworkerPreferenceBonus;
+    values[(int) Weight::AVERAGE_PROPORTION] = averageProportion;
+    values[(int) Weight::LOWEST_PROPORTION] = lowestProportion;
+    values[(int) Weight::RANGE_PROPORTION] = overbookedRange;
+    buildTables();
+}
+
+double ScoreWeights::get(Weight weight) const {
+    return values[(int) weight];
+}
+
+// throws a runtime_error if the value is out of range for the weight
+void ScoreWeights::set(Weight weight, double value) {
+    bool proportion = weight == Weight::AVERAGE_PROPORTION or
+                      weight == Weight::LOWEST_PROPORTION or
+                      weight == Weight::RANGE_PROPORTION;
+    if (not isfinite(value) or
+        (not proportion and (value < 0 or value > MAX_PENALTY))) {
+        throw runtime_error("Error: " + weightName(weight) + " out of range: " +
+                            to_string(value));
+    }
+    values[(int) weight] = value;
+    buildTables();
+}
+
+double ScoreWeights::getAverageProportion() const {
+    return values[(int) Weight::AVERAGE_PROPORTION];
+}
+
+double ScoreWeights::getLowestProportion() const {
+    return values[(int) Weight::LOWEST_PROPORTION];
+}
+
+double ScoreWeights::getRangeProportion() const {
+    return values[(int) Weight::RANGE_PROPORTION];
+}
+
+double ScoreWeights::getCoworkerBonus() const {
+    return values[(int) Weight::COWORKER_BONUS];
+}
+
+Fixed ScoreWeights::penaltyFor(int numDoubleDay, int numDoubleShift) const {
+    return doubleDayPenalties[numDoubleDay] + doubleShiftPenalties[numDoubleShift];
+}
+
+Fixed ScoreWeights::bonusFor(int numLiked) const {
+    return numLiked * coworkerBonus;
+}
+
+void ScoreWeights::buildTables() {
+    doubleDayPenalties = penaltyTable(values[(int) Weight::DOUBLE_DAY_PENALTY]);
+    doubleShiftPenalties =
+        penaltyTable(values[(int) Weight::DOUBLE_SHIFT_PENALTY]);
+    coworkerBonus = toFixed(values[(int) Weight::COWORKER_BONUS]);
+}
+
+// Calculates the correct penalty to apply given the number of times the penalty
+// occurred, the multiplication factor, as well as the penalty that should be
+// applied for each infraction
+// NOTE: does not include times when calculating the final return value, because
+//       the assumption is that this penalty will also be called for all other
+//       instances. For example, in a double shift, both shifts would be
+//       individual penalties/infractions.
+// times = 1, factor = 2, penalty = 0.5
+static double exponeniatePenalty(int times, double factor, double penalty) {
+    if (times == 0) {
+        return 0;
+    }
+
+    // TODO: is this the best punishment function?
+    // times - 1 because this is a scaler for if there are multiple problems
+    double finalFactor = pow(factor, times - 1);
+
+    return (finalFactor * penalty) / (times + 1);
+}
+
+// the penalty for each number of times it occurred, indexed by times
+static array<Fixed, MAX_SHIFTS> penaltyTable(double penalty) {
+    array<Fixed, MAX_SHIFTS> table;
+    for (int times = 0; times < MAX_SHIFTS; times++) {
+        table[times] = toFixed(exponeniatePenalty(times, 2, penalty));
+    }
+    return table;
+}
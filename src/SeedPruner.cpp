@@ -0,0 +1,54 @@
+#include "SeedPruner.h"
+
+SeedPruner::SeedPruner(double newSafety) : best(-1.0) {
+    safety = newSafety;
+    for (size_t i = 0; i < MAX_CHECKPOINTS; i++) {
+        gains[i].maxGain.store(0.0);
+        gains[i].seeds.store(0);
+    }
+}
+
+bool SeedPruner::isEnabled() const {
+    return safety > 0;
+}
+
+// raises the shared best with compare and swap, since threads race to set it
+bool SeedPruner::offerBest(double score) {
+    double current = best.load(memory_order_relaxed);
+    while (current < 0 or score > current) {
+        if (best.compare_exchange_weak(current, score, memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+double SeedPruner::getBest() const {
+    return best.load(memory_order_relaxed);
+}
+
+// learns from a seed that was balanced to the end
+void SeedPruner::recordGains(double finalScore, 
+                             const vector<double> &checkpointScores) {
+    for (size_t i = 0; i < checkpointScores.size(); i++) {
+        LearnedGain &learned = gains[min(i, MAX_CHECKPOINTS - 1)];
+        double gain = finalScore - checkpointScores[i];
+        double current = learned.maxGain.load(memory_order_relaxed);
+        while (gain > current and 
+               !learned.maxGain.compare_exchange_weak(current, gain, 
+                                                      memory_order_relaxed)) {
+        }
+        learned.seeds.fetch_add(1, memory_order_relaxed);
+    }
+}
+
+bool SeedPruner::hopeless(size_t checkpoint, double checkpointScore) const {
+    const LearnedGain &learned = gains[min(checkpoint, MAX_CHECKPOINTS - 1)];
+    if (!isEnabled() or learned.seeds.load(memory_order_relaxed) < WARMUP_SEEDS) {
+        return false;
+    }
+    double currentBest = best.load(memory_order_relaxed);
+    return currentBest >= 0 and 
+           checkpointScore + safety * learned.maxGain.load(memory_order_relaxed) 
+               < currentBest;
+}
@@ -0,0 +1,477 @@
+#include "SeedSweep.h"
+
+SeedSweep::SeedSweep(WorkerInputData &data, const RunOptions &newOptions,
+                     ThreadPool *newPool)
+    : inputData(data), options(newOptions), bound(data), seedsHandedOut(0),
+      withinGap(false), pruner(newOptions.pruneSafety), 
+      pareto(newOptions.paretoOut != "", 
+             data.getWeights().getRangeProportion() > 0),
+      startStates(STATE_SET_LOG2), finalStates(STATE_SET_LOG2),
+      elite(newOptions.elite) {
+    pool = newPool;
+    label = "";
+    relinkRounds = relinkPaths = relinkAdded = 0;
+    relinkSeconds = 0;
+    relinkedBetter = false;
+    firstSeed = options.firstSeed;
+    lastSeed = options.lastSeed;
+
+    total.bestSeed = firstSeed;
+    secondsTaken = 0;
+
+    firstSeedAllocations = 0;
+    laterAllocations = 0;
+}
+
+// applies the command line options that change how a single seed is run
+void SeedSweep::configureScheduler(Scheduler &scheduler,
+                                   const RunOptions &options,
+                                   ThreadPool *pool) {
+    scheduler.setThreadPool(pool);
+    scheduler.setBatchBalance(options.batchBalance);
+    scheduler.setValidation(options.validation);
+}
+
+// a portfolio takes turns through every construction by seed. With
+// --adaptive the sweep picks instead, and the best seed's is kept
+Perturbation SeedSweep::perturbationFor(const RunOptions &options,
+                                        unsigned int seed) {
+    Perturbation perturbation;
+    perturbation.construction = options.construction;
+    if (options.portfolio) {
+        perturbation.construction = (Construction) (seed % NUM_CONSTRUCTIONS);
+    }
+    perturbation.noiseDivisor = options.noiseDivisor;
+    return perturbation;
+}
+
+// e.g. which component of the input this sweep is of
+void SeedSweep::setLabel(const string &newLabel) {
+    label = newLabel;
+}
+
+// tries every seed in the range, or until keepGoing is cleared by SIGINT.
+// With --threads each thread sweeps its own copy of the input, taking the
+// next seed from a shared counter
+void SeedSweep::run(const atomic<bool> &keepGoing) {
+    auto t1 = chrono::high_resolution_clock::now();
+
+    cerr << label;
+    bound.print(cerr);
+    unsigned long long startAllocations = AllocationCounter::getCount();
+    if (options.seedLog != "") {
+        seedLog.open(options.seedLog);
+        if (!seedLog) {
+            throw runtime_error("Error: cannot write " + options.seedLog);
+        }
+        seedLog << "seed\tconstruction\tnoise\tscore" << endl;
+    }
+
+    int numThreads = options.threads;
+    vector<Tally> tallies(numThreads);
+    if (numThreads == 1) {
+        sweep(inputData, tallies[0], keepGoing);
+    } else {
+        vector<unique_ptr<WorkerInputData>> copies;
+        vector<thread> threads;
+        for (int i = 1; i < numThreads; i++) {
+            copies.emplace_back(new WorkerInputData(inputData));
+        }
+        for (int i = 1; i < numThreads; i++) {
+            threads.emplace_back(&SeedSweep::sweep, this, 
+                                 ref(*copies[i - 1]), ref(tallies[i]), 
+                                 cref(keepGoing));
+        }
+        sweep(inputData, tallies[0], keepGoing);
+        for (size_t i = 0; i < threads.size(); i++) {
+            threads[i].join();
+        }
+    }
+
+    for (int i = 0; i < numThreads; i++) {
+        addTally(tallies[i]);
+    }
+
+    if (numThreads == 1) {
+        laterAllocations = AllocationCounter::getCount() - startAllocations 
+                           - firstSeedAllocations;
+    }
+
+    auto t2 = chrono::high_resolution_clock::now();
+    auto ms_int = chrono::duration_cast<chrono::milliseconds>(t2 - t1); // TODO: add chrono as command line, not just something that always happens
+    secondsTaken = (double) ms_int.count() / 1000;
+
+    // written even when interrupted, like the best result
+    if (pareto.isEnabled()) {
+        pareto.write(options.paretoOut);
+    }
+
+    // timed on its own, so seeds per second stays comparable
+    if (elite.isEnabled() and keepGoing) {  // Ctrl-C wants the result now
+        relinkElite();
+    }
+}
+
+// one thread's share of the sweep. One scheduler is reset for every seed so
+// its containers are reused
+void SeedSweep::sweep(WorkerInputData &data, Tally &tally, 
+                      const atomic<bool> &keepGoing) {
+    unsigned long long startAllocations = AllocationCounter::getCount();
+
+    Scheduler scheduler(data, firstSeed);
+    configureScheduler(scheduler, options, pool);
+    scheduler.setPruner(&pruner);
+    unsigned int seed;
+    bool firstRun = true;
+    while (keepGoing and !withinGap and nextSeed(seed)) {
+        if (!(firstRun and seed == firstSeed)) {
+            scheduler.reset(seed);
+        }
+        int arm = options.adaptive ? bandit.choose() : -1;
+        scheduler.setPerturbation(arm >= 0 ? bandit.getArm(arm) 
+                                           : perturbationFor(options, seed));
+        double score = runSeed(scheduler, tally);
+        if (arm >= 0) {
+            bandit.reward(arm, score);
+        }
+        if (seedLog.is_open()) {
+            logSeed(scheduler, score);
+        }
+
+        if (seed % 1000 == 0) { // useful for determining speed
+            cerr << label << "At Seed: " << seed << endl;
+        }
+
+        tally.seedsChecked++;
+        if (firstRun and options.threads == 1) {
+            firstSeedAllocations = AllocationCounter::getCount() - startAllocations;
+        }
+        firstRun = false;
+
+        double best = pruner.getBest();
+        if (options.gap >= 0 and best >= 0 and bound.gap(best) <= options.gap) {
+            if (!withinGap.exchange(true)) {
+                lock_guard<mutex> lock(printLock);
+                cerr << label << "Best result is within " << options.gap 
+                     << " of the upper bound" << endl;
+            }
+        }
+    }
+
+    data.resetValues();
+}
+
+// false once every seed in the range was handed out
+bool SeedSweep::nextSeed(unsigned int &seed) {
+    unsigned long long offset = seedsHandedOut.fetch_add(1);
+    if (offset > (unsigned long long) (lastSeed - firstSeed)) {
+        return false;
+    }
+    seed = firstSeed + offset;
+    return true;
+}
+
+// the score of the seed, or -1 if it was skipped or pruned
+double SeedSweep::runSeed(Scheduler &scheduler, Tally &tally) {
+    auto start = chrono::steady_clock::now();
+
+    scheduler.construct();
+
+    // the rest of the run only differs from the earlier seed's by noise
+    bool repeatedStart = !startStates.insert(scheduler.getStateHash());
+    if (repeatedStart) {
+        tally.repeatedStarts++;
+    }
+    if (repeatedStart and options.skipRepeats) {
+        tally.seedsSkipped++;
+        return -1;
+    }
+
+    scheduler.balance();
+    chrono::duration<double> seconds = chrono::steady_clock::now() - start;
+    if (scheduler.getAbandoned()) {
+        tally.seedsPruned++;
+        tally.prunedSeconds += seconds.count();
+        return -1;
+    }
+    tally.completeSeconds += seconds.count();
+
+    if (!finalStates.insert(scheduler.getStateHash())) {
+        tally.repeatedFinals++;
+    }
+    recordResult(scheduler, tally);
+    return scheduler.getScore();
+}
+
+// counts a balanced seed towards the stats and the best seed
+void SeedSweep::recordResult(Scheduler &scheduler, Tally &tally) {
+    double average = scheduler.getAverage();
+    double lowest = scheduler.getLeastHappy();
+    int range = scheduler.getRange();
+    double result = scheduler.getScore();
+    unsigned int seed = scheduler.getSeed();
+    tally.balanceIterations += scheduler.getBalanceIterations();
+
+    if (pruner.isEnabled()) {
+        pruner.recordGains(result, scheduler.getCheckpointScores());
+    }
+
+    ConstructionStats &stats = tally.constructionStats[(int) scheduler.getConstruction()];
+    stats.seeds++;
+    stats.scoreSum += result;
+    stats.bestScore = max(stats.bestScore, result);
+
+    // ties go to the lower seed, which is the one a single thread keeps
+    if (tally.bestScore < 0 or result > tally.bestScore or 
+        (result == tally.bestScore and seed < tally.bestSeed)) {
+        tally.bestScore = result;
+        tally.bestSeed = seed;
+        tally.bestPerturbation = scheduler.getPerturbation();
+    }
+
+    if (pareto.isEnabled()) {
+        ParetoPoint point;
+        point.average = average;
+        point.lowest = lowest;
+        point.range = range;
+        point.score = result;
+        point.seed = seed;
+        point.perturbation = scheduler.getPerturbation();
+        pareto.offer(point);
+    }
+
+    if (elite.accepts(result, seed)) {
+        EliteSchedule schedule;
+        scheduler.snapshot(schedule, result);
+        elite.offer(schedule);
+    }
+
+    if (pruner.offerBest(result)) {
+        stats.wins++;
+        lock_guard<mutex> lock(printLock);
+        cerr << label << "Best Result: Average = " << average 
+             << ", lowest = " << lowest << ", range = " << range << ", seed = " << seed 
+             << ", gap = " << bound.gap(result) << endl;
+    }
+}
+
+// in the order seeds finish, which with --threads is not quite by seed
+void SeedSweep::logSeed(const Scheduler &scheduler, double score) {
+    Perturbation perturbation = scheduler.getPerturbation();
+    lock_guard<mutex> lock(logLock);
+    seedLog << scheduler.getSeed() << '\t' 
+            << constructionName(perturbation.construction) << '\t' 
+            << 1 / perturbation.noiseDivisor << '\t';
+    if (scheduler.getAbandoned()) {
+        seedLog << "pruned";
+    } else if (score < 0) {
+        seedLog << "skipped";
+    } else {
+        seedLog << setprecision(17) << score << setprecision(6);
+    }
+    seedLog << '\n';
+}
+
+void SeedSweep::addTally(const Tally &tally) {
+    if (tally.bestScore >= 0 and 
+        (total.bestScore < 0 or tally.bestScore > total.bestScore or 
+         (tally.bestScore == total.bestScore and 
+          tally.bestSeed < total.bestSeed))) {
+        total.bestScore = tally.bestScore;
+        total.bestSeed = tally.bestSeed;
+        total.bestPerturbation = tally.bestPerturbation;
+    }
+
+    total.seedsChecked += tally.seedsChecked;
+    total.balanceIterations += tally.balanceIterations;
+    total.repeatedStarts += tally.repeatedStarts;
+    total.repeatedFinals += tally.repeatedFinals;
+    total.seedsSkipped += tally.seedsSkipped;
+    total.seedsPruned += tally.seedsPruned;
+    total.completeSeconds += tally.completeSeconds;
+    total.prunedSeconds += tally.prunedSeconds;
+
+    for (int i = 0; i < NUM_CONSTRUCTIONS; i++) {
+        const ConstructionStats &from = tally.constructionStats[i];
+        ConstructionStats &to = total.constructionStats[i];
+        to.seeds += from.seeds;
+        to.wins += from.wins;
+        to.scoreSum += from.scoreSum;
+        to.bestScore = max(to.bestScore, from.bestScore);
+    }
+}
+
+// path relinking between every pair in the pool, from the better schedule
+// towards the worse, so that the search stays near the better one. Every
+// pair is relinked once, also over several rounds, and the best schedule on
+// each path is offered back to the pool
+void SeedSweep::relinkElite() {
+    auto start = chrono::steady_clock::now();
+
+    Scheduler scheduler(inputData, firstSeed);
+    configureScheduler(scheduler, options, pool);
+    const vector<TimeSlotNode *> &slotList = inputData.getSlotList();
+    vector<TimeSlotNode *> slots;
+    vector<pair<uint64_t, uint64_t>> linked;  // hashes of pairs relinked
+    for (relinkRounds = 0; relinkRounds < MAX_RELINK_ROUNDS; ) {
+        vector<EliteSchedule> schedules = elite.getSchedules();
+        relinkRounds++;
+        int added = 0;
+        for (size_t i = 0; i < schedules.size(); i++) {
+            for (size_t j = i + 1; j < schedules.size(); j++) {
+                pair<uint64_t, uint64_t> hashes = {schedules[i].hash, 
+                                                   schedules[j].hash};
+                if (find(linked.begin(), linked.end(), hashes) != linked.end()) {
+                    continue;
+                }
+                linked.push_back(hashes);
+
+                slots.clear();
+                for (size_t k = 0; k < schedules[i].slotIds.size(); k++) {
+                    slots.push_back(slotList[schedules[i].slotIds[k]]);
+                }
+                scheduler.reset(schedules[i].seed);
+                scheduler.setPerturbation(schedules[i].perturbation);
+                scheduler.loadSchedule(slots);
+
+                EliteSchedule found;
+                relinkPaths++;
+                if (scheduler.relink(schedules[j].slotIds, found) and 
+                    elite.offer(found)) {
+                    added++;
+                }
+            }
+        }
+        relinkAdded += added;
+        if (added == 0) {
+            break;
+        }
+    }
+
+    vector<EliteSchedule> schedules = elite.getSchedules();
+    if (!schedules.empty() and schedules.front().score > total.bestScore) {
+        relinkedBetter = true;
+        relinkedBest = schedules.front();
+    }
+    chrono::duration<double> seconds = chrono::steady_clock::now() - start;
+    relinkSeconds = seconds.count();
+}
+
+// null unless relinking found a schedule better than every seed's
+const EliteSchedule *SeedSweep::getRelinkedBest() const {
+    return relinkedBetter ? &relinkedBest : nullptr;
+}
+
+unsigned int SeedSweep::getBestSeed() const {
+    return total.bestSeed;
+}
+
+// how the best seed was run, so that it can be run again
+Perturbation SeedSweep::getBestPerturbation() const {
+    return total.bestPerturbation;
+}
+
+unsigned int SeedSweep::getSeedsChecked() const {
+    return total.seedsChecked;
+}
+
+// of the best seed, or of path relinking if it found better. -1 if no seed
+// was scored
+double SeedSweep::getBestScore() const {
+    return relinkedBetter ? relinkedBest.score : total.bestScore;
+}
+
+void SeedSweep::printProfile(ostream &output) const {
+    unsigned int seedsChecked = total.seedsChecked;
+    output << "Time taken (s): " << secondsTaken << endl;
+    output << "Iterations per second: " << (double) seedsChecked / secondsTaken << endl;
+    output << "Priority kernels: " 
+           << (PriorityKernels::usingAvx2() ? "AVX2" : "scalar") << endl;
+    if (options.threads == 1) {  // the counter is shared by every thread
+        output << "Heap allocations, first seed: " << firstSeedAllocations << endl;
+        if (seedsChecked > 1) {
+            output << "Heap allocations per later seed: " 
+                   << (double) laterAllocations / (seedsChecked - 1) << endl;
+        }
+    }
+
+    unsigned int seedsScored = seedsChecked - total.seedsSkipped 
+                               - total.seedsPruned;
+    if (seedsScored > 0) {
+        output << "Balance iterations per seed: " 
+               << (double) total.balanceIterations / seedsScored << endl;
+        output << "Repeated final schedules: " << total.repeatedFinals << " ("
+               << 100.0 * total.repeatedFinals / seedsScored << "%)" << endl;
+    }
+    output << "Repeated initial allocations: " << total.repeatedStarts << " ("
+           << 100.0 * total.repeatedStarts / seedsChecked << "%)";
+    if (options.skipRepeats) {
+        output << ", skipped";
+    }
+    output << endl;
+
+    if (pruner.isEnabled()) {
+        // a pruned seed would have taken as long as an average scored one
+        double saved = 0;
+        if (seedsScored > 0) {
+            saved = total.seedsPruned * total.completeSeconds / seedsScored 
+                    - total.prunedSeconds;
+        }
+        output << "Seeds pruned: " << total.seedsPruned << " ("
+               << 100.0 * total.seedsPruned / seedsChecked 
+               << "%), estimated time saved (s): " << saved << endl;
+    }
+
+    if (total.bestScore >= 0) {
+        output << "Optimality gap: " << bound.gap(total.bestScore) 
+               << " (upper bound " << bound.getScoreBound() << ")" << endl;
+    }
+    printConstructionStats(output);
+    if (options.adaptive) {
+        bandit.print(output);
+    }
+    if (pareto.isEnabled()) {
+        output << "Pareto front: " << pareto.size() << " schedules of " 
+               << pareto.getOffered() << " scored, written to " 
+               << options.paretoOut << endl;
+    }
+    if (elite.isEnabled()) {
+        printElite(output);
+    }
+}
+
+void SeedSweep::printElite(ostream &output) const {
+    vector<EliteSchedule> schedules = elite.getSchedules();
+    output << "Elite pool: " << schedules.size() << " of " 
+           << elite.getCapacity() << " schedules";
+    if (!schedules.empty()) {
+        output << ", scores " << schedules.back().score << " to " 
+               << schedules.front().score;
+    }
+    output << endl;
+    output << "Path relinking: " << relinkPaths << " paths in " << relinkRounds
+           << " rounds, " << relinkAdded << " schedules added, " 
+           << relinkSeconds << " s";
+    if (relinkedBetter) {
+        output << ", best score " << total.bestScore << " -> " 
+               << relinkedBest.score;
+    }
+    output << endl;
+}
+
+// one line per construction that was run
+void SeedSweep::printConstructionStats(ostream &output) const {
+    output << "Construction: seeds, wins, win rate, average score, best score" 
+           << endl;
+    for (int i = 0; i < NUM_CONSTRUCTIONS; i++) {
+        const ConstructionStats &stats = total.constructionStats[i];
+        if (stats.seeds == 0) {
+            continue;
+        }
+        output << "    " << constructionName((Construction) i) << ": " 
+               << stats.seeds << ", " << stats.wins << ", " 
+               << (double) stats.wins / stats.seeds << ", " 
+               << stats.scoreSum / stats.seeds << ", " << stats.bestScore 
+               << endl;
+    }
+}
@@ -0,0 +1,156 @@
+#include "ShardResult.h"
+
+/******************************** Constructors ********************************/
+
+// takes a calculated scheduler for the best seed of the shard
+ShardResult::ShardResult(Scheduler &scheduler, unsigned int newFirstSeed,
+                         unsigned int newLastSeed,
+                         unsigned int newSeedsChecked) {
+    firstSeed = newFirstSeed;
+    lastSeed = newLastSeed;
+    seedsChecked = newSeedsChecked;
+
+    bestSeed = scheduler.getSeed();
+    score = scheduler.getScore();
+    average = scheduler.getAverage();
+    lowest = scheduler.getLeastHappy();
+    range = scheduler.getRange();
+
+    const vector<vector<vector<TimeSlotNode *>>> &schedule 
+            = scheduler.getFinalSchedule();
+    assignment = vector<vector<vector<string>>>(NUM_DAYS, vector<vector<string>>(MAX_SHIFTS));
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            for (size_t k = 0; k < schedule[i][j].size(); k++) {
+                assignment[i][j].push_back(schedule[i][j][k]->getParent()->getName());
+            }
+        }
+    }
+}
+
+ShardResult::ShardResult(const string &fileName) {
+    ifstream infile(fileName);
+    if (not infile.is_open()) {
+        throw runtime_error("Unable to open file " + fileName);
+    }
+    read(infile, fileName);
+}
+
+// picks the best result out of all the files. Seed ranges and the number of
+// seeds checked are combined so merged files can be merged again
+ShardResult ShardResult::merge(const vector<string> &fileNames) {
+    ShardResult best(fileNames.front());
+    unsigned int totalChecked = best.seedsChecked;
+    unsigned int minSeed = best.firstSeed;
+    unsigned int maxSeed = best.lastSeed;
+    for (size_t i = 1; i < fileNames.size(); i++) {
+        ShardResult curr(fileNames[i]);
+        totalChecked += curr.seedsChecked;
+        minSeed = min(minSeed, curr.firstSeed);
+        maxSeed = max(maxSeed, curr.lastSeed);
+        if (curr.betterThan(best)) {
+            best = curr;
+        }
+    }
+
+    best.seedsChecked = totalChecked;
+    best.firstSeed = minSeed;
+    best.lastSeed = maxSeed;
+    return best;
+}
+
+// ties go to the lower seed, which is what a single sequential sweep keeps
+bool ShardResult::betterThan(const ShardResult &other) const {
+    return score > other.score or
+           (score == other.score and bestSeed < other.bestSeed);
+}
+
+/*********************************** Writing **********************************/
+
+void ShardResult::write(const string &fileName) const {
+    ofstream outfile(fileName);
+    if (not outfile.is_open()) {
+        throw runtime_error("Unable to open file " + fileName);
+    }
+
+    outfile << setprecision(17);
+    outfile << "seedRange " << firstSeed << " " << lastSeed << endl;
+    outfile << "seedsChecked " << seedsChecked << endl;
+    outfile << "bestSeed " << bestSeed << endl;
+    outfile << "score " << score << endl;
+    outfile << "average " << average << endl;
+    outfile << "lowest " << lowest << endl;
+    outfile << "range " << range << endl;
+    outfile << "assignment" << endl;
+    printAssignment(outfile);
+
+    if (outfile.fail()) {
+        throw runtime_error("Unable to write file " + fileName);
+    }
+}
+
+/*********************************** Reading **********************************/
+
+void ShardResult::read(istream &input, const string &fileName) {
+    string key;
+    input >> key >> firstSeed >> lastSeed;
+    input >> key >> seedsChecked;
+    input >> key >> bestSeed;
+    input >> key >> score;
+    input >> key >> average;
+    input >> key >> lowest;
+    input >> key >> range;
+    input >> key;
+    if (input.fail() or key != "assignment") {
+        throw runtime_error("Malformed result file " + fileName);
+    }
+    readAssignment(input, fileName);
+}
+
+// one line per shift: day, shift, then the workers on it, all tab separated
+void ShardResult::readAssignment(istream &input, const string &fileName) {
+    assignment = vector<vector<vector<string>>>(NUM_DAYS, vector<vector<string>>(MAX_SHIFTS));
+
+    string lineContents;
+    getline(input, lineContents);  // rest of the "assignment" line
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            if (not getline(input, lineContents)) {
+                throw runtime_error("Malformed result file " + fileName);
+            }
+
+            istringstream line(lineContents);
+            string dayName, shiftName, name;
+            getline(line, dayName, '\t');
+            getline(line, shiftName, '\t');
+            if (dayName != dayNames[i] or shiftName != shiftNames[j]) {
+                throw runtime_error("Result file " + fileName + " does not "
+                                    "match this schedule layout");
+            }
+            while (getline(line, name, '\t')) {
+                assignment[i][j].push_back(name);
+            }
+        }
+    }
+}
+
+/********************************** Printing **********************************/
+
+void ShardResult::printSummary(ostream &output) const {
+    output << "Best Result: Average = " << average << ", lowest = " << lowest
+           << ", range = " << range << ", seed = " << bestSeed << endl;
+    output << "Seeds " << firstSeed << " to " << lastSeed << ", "
+           << seedsChecked << " checked" << endl;
+}
+
+void ShardResult::printAssignment(ostream &output) const {
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            output << dayNames[i] << '\t' << shiftNames[j];
+            for (size_t k = 0; k < assignment[i][j].size(); k++) {
+                output << '\t' << assignment[i][j][k];
+            }
+            output << endl;
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#include "StateSet.h"
+
+StateSet::StateSet(int capacityLog2) {
+    mask = ((size_t) 1 << capacityLog2) - 1;
+    slots.reset(new atomic<uint64_t>[mask + 1]);
+    for (size_t i = 0; i <= mask; i++) {
+        slots[i].store(EMPTY, memory_order_relaxed);
+    }
+}
+
+// linear probing from the low bits of the hash
+bool StateSet::insert(uint64_t hash) {
+    if (hash == EMPTY) {
+        hash = 1;  // EMPTY marks unused slots
+    }
+
+    for (int i = 0; i < MAX_PROBES; i++) {
+        atomic<uint64_t> &slot = slots[(hash + i) & mask];
+        uint64_t current = slot.load(memory_order_relaxed);
+        if (current == EMPTY and 
+            slot.compare_exchange_strong(current, hash, memory_order_relaxed)) {
+            return true;
+        }
+        if (current == hash) {
+            return false;
+        }
+    }
+    return true;  // no room near its slot, not remembered
+}
+
+size_t StateSet::getCapacity() const {
+    return mask + 1;
+}
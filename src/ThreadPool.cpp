@@ -0,0 +1,89 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int numThreads) {
+    generation = 0;
+    threadsBusy = 0;
+    stopping = false;
+    currFunction = nullptr;
+    currTask = nullptr;
+    numIndices = 0;
+    nextIndex = 0;
+
+    // the calling thread is thread 0
+    for (int i = 1; i < numThreads; i++) {
+        threads.emplace_back(&ThreadPool::threadLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        unique_lock<mutex> guard(lock);
+        stopping = true;
+    }
+    workReady.notify_all();
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+int ThreadPool::getNumThreads() const {
+    return threads.size() + 1;
+}
+
+void ThreadPool::run(int n, void (*newFunction)(void *, int, int),
+                     void *newTask) {
+    if (threads.empty() or n <= 1) {  // not worth waking anyone up
+        for (int i = 0; i < n; i++) {
+            newFunction(newTask, i, 0);
+        }
+        return;
+    }
+
+    {
+        unique_lock<mutex> guard(lock);
+        currFunction = newFunction;
+        currTask = newTask;
+        numIndices = n;
+        nextIndex = 0;
+        threadsBusy = threads.size();
+        generation++;
+    }
+    workReady.notify_all();
+
+    workOn(0);
+
+    unique_lock<mutex> guard(lock);
+    workDone.wait(guard, [this] { return threadsBusy == 0; });
+}
+
+// takes indices until there are none left
+void ThreadPool::workOn(int thread) {
+    int index;
+    while ((index = nextIndex.fetch_add(1)) < numIndices) {
+        currFunction(currTask, index, thread);
+    }
+}
+
+void ThreadPool::threadLoop(int thread) {
+    unsigned long seenGeneration = 0;
+    while (true) {
+        {
+            unique_lock<mutex> guard(lock);
+            workReady.wait(guard, [&] {
+                return stopping or generation != seenGeneration;
+            });
+            if (stopping) {
+                return;
+            }
+            seenGeneration = generation;
+        }
+
+        workOn(thread);
+
+        unique_lock<mutex> guard(lock);
+        threadsBusy--;
+        if (threadsBusy == 0) {
+            workDone.notify_one();
+        }
+    }
+}
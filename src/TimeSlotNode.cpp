@@ -1,19 +1,19 @@
 #include "TimeSlotNode.h"
 
 TimeSlotNode::TimeSlotNode(WorkerNode *newParent, int newDay, int newShift,
-                           double newPriority) {
+                           Fixed newPriority) {
     resetRunValues();
 
     parent = newParent;
+    id = -1;
     day = newDay;
     shift = newShift;
     truePriority = newPriority;
+    forced = false;
 }
 
 void TimeSlotNode::resetRunValues() {
     used = false;
-    seen = false;
-    prev = nullptr;
     memoizedPriority = 0;
 }
 
@@ -30,11 +30,11 @@ void TimeSlotNode::resetMemoizedPriority(const vector<vector<vector<TimeSlotNode
     memoizedPriority = calcBonus(workers) - calcPenalty();
 }
 
-double TimeSlotNode::getMemoizedPriority(bool useTruePriority) const {
+Fixed TimeSlotNode::getMemoizedPriority(bool useTruePriority) const {
     return (useTruePriority ? truePriority : priority) + memoizedPriority;
 }
 
-double TimeSlotNode::getPriority(
+Fixed TimeSlotNode::getPriority(
     const vector<vector<vector<TimeSlotNode *>>> &workers,
     bool useTruePriority) const {
     
@@ -45,8 +45,8 @@ double TimeSlotNode::getPriority(
 
 // Note: penalty applies exponentially compared to how many shifts they are on 
 // in a row.
-double TimeSlotNode::calcPenalty() const {
-    double penalty = 0;
+Fixed TimeSlotNode::calcPenalty() const {
+    Fixed penalty = 0;
     int numDoubleDay = 0;
     int numDoubleShift = 0;
     const vector<TimeSlotNode *> &allocations = parent->getAllocations();
@@ -64,34 +64,13 @@ double TimeSlotNode::calcPenalty() const {
         }
     }
 
-    penalty += exponeniatePenalty(numDoubleDay, 2, doubleDayPenalty);
-    penalty += exponeniatePenalty(numDoubleShift, 2, doubleShiftPenalty);
+    penalty += parent->getWeights().penaltyFor(numDoubleDay, numDoubleShift);
     return penalty;
 }
 
-// Calculates the correct penalty to apply given the number of times the penalty
-// occurred, the multiplication factor, as well as the penalty that should be
-// applied for each infraction
-// NOTE: does not include times when calculating the final return value, because
-//       the assumption is that this penalty will also be called for all other
-//       instances. For example, in a double shift, both shifts would be
-//       individual penalties/infractions.
-// times = 1, factor = 2, penalty = 0.5
-double TimeSlotNode::exponeniatePenalty(int times, double factor, double penalty) const {
-    if (times == 0) {
-        return 0;
-    }
-
-    // TODO: is this the best punishment function?
-    // times - 1 because this is a scaler for if there are multiple problems
-    double finalFactor = pow(factor, times - 1);
-    
-    return (finalFactor * penalty) / (times + 1);
-}
-
-double TimeSlotNode::calcBonus(
+Fixed TimeSlotNode::calcBonus(
     const vector<vector<vector<TimeSlotNode *>>> &workers) const {
-    double bonus = 0;
+    int numLiked = 0;
 
     // check for the coworkerPreference bonus:
     //     Note: Bonus applies linearly to how many people they are on shift
@@ -101,19 +80,23 @@ double TimeSlotNode::calcBonus(
     const unordered_set<WorkerNode *> &likes = parent->getLikedCoworkers();
     for (auto toMatch = timeslot.begin(); toMatch != timeslot.end(); toMatch++) {
         if (likes.find((*toMatch)->getParent()) != likes.end()) {
-            bonus += coworkerPreferenceBonus;
+            numLiked++;
         }
     }
 
-    return bonus;
+    return parent->getWeights().bonusFor(numLiked);
 }
 
 /***************************** Getters and Setters ****************************/
 
-double TimeSlotNode::getTruePriority() const {
+Fixed TimeSlotNode::getTruePriority() const {
     return truePriority;
 }
 
+int TimeSlotNode::getId() const {
+    return id;
+}
+
 int TimeSlotNode::getDay() const {
     return day;
 }
@@ -130,31 +113,29 @@ bool TimeSlotNode::getUsed() const {
     return used;
 }
 
-bool TimeSlotNode::getSeen() const {
-    return seen;
+bool TimeSlotNode::getForced() const {
+    return forced;
 }
-TimeSlotNode *TimeSlotNode::getPrev() const {
-    return prev;
+
+
+void TimeSlotNode::setId(int newId) {
+    id = newId;
 }
 
-void TimeSlotNode::setTruePriority(double newPriority) {
+void TimeSlotNode::setTruePriority(Fixed newPriority) {
     truePriority = newPriority;
 }
 
-void TimeSlotNode::setPriority(double newPriority) {
+void TimeSlotNode::setPriority(Fixed newPriority) {
     priority = newPriority;
 }
 
-void TimeSlotNode::setSeen(bool newValue) {
-    seen = newValue;
-}
-
 void TimeSlotNode::setUsed(bool newValue) {
     used = newValue;
 }
 
-void TimeSlotNode::setPrev(TimeSlotNode *newPrev) {
-    prev = newPrev;
+void TimeSlotNode::setForced(bool newValue) {
+    forced = newValue;
 }
 
 /*********************************** Printing *********************************/
@@ -165,7 +146,7 @@ void TimeSlotNode::printTime(ostream &output) const {
 
 // delete because never used
 void TimeSlotNode::printInfo(ostream &output) const {
-    output << "    " << parent->getName() << ", " << priority;
+    output << "    " << parent->getName() << ", " << fromFixed(priority);
 }
 
 void TimeSlotNode::print(ostream &output) const {
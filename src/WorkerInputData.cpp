@@ -2,7 +2,7 @@
 
 /******************************** Constructors ********************************/
 
-WorkerInputData::WorkerInputData(string inputDirectory) {
+WorkerInputData::WorkerInputData(string inputPath) {
     // TODO: this is a bit brain dead. Maybe just fail/throw an error if 
     //       there needs to be a change?
     // transfer workersPerShift to non-const so it can be changed when validated
@@ -14,14 +14,83 @@ WorkerInputData::WorkerInputData(string inputDirectory) {
     }
 
     // read in data from files
-    readFiles(inputDirectory);
+    readInput(inputPath);
 
     buildWorkersAvailable();
+    assignIds();
     normalizePriority();
+    findSymmetryClasses();
+    presolved = false;
 
     validate(cerr);
 }
 
+// deep copy of the input, so that another thread can run Schedulers on it.
+// Ids and the order of workers and slots are the same as in other, run values
+// start fresh
+WorkerInputData::WorkerInputData(const WorkerInputData &other) {
+    vector<int> workerIds(other.workerList.size());
+    for (size_t i = 0; i < workerIds.size(); i++) {
+        workerIds[i] = i;
+    }
+    copyWorkers(other, workerIds);
+}
+
+// copy of the given workers of other only, in that order, with the shifts
+// none of them is available for needing nobody. Priorities stay normalized
+// over all of other. Likes of workers outside the subset are dropped; they
+// never share a shift with the subset, so they could not give a bonus
+WorkerInputData::WorkerInputData(const WorkerInputData &other, 
+                                 const vector<int> &workerIds) {
+    copyWorkers(other, workerIds);
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            if (workersAvailable[i][j].empty()) {
+                workersPerShift[i][j] = 0;
+            }
+        }
+    }
+}
+
+void WorkerInputData::copyWorkers(const WorkerInputData &other,
+                                  const vector<int> &workerIds) {
+    workersPerShift = other.workersPerShift;
+    weights = other.weights;
+
+    vector<int> newIds(other.workerList.size(), -1);
+    for (size_t i = 0; i < workerIds.size(); i++) {
+        const WorkerNode *otherWorker = other.workerList[workerIds[i]];
+        WorkerNode *newWorker = new WorkerNode(otherWorker->getName(),
+                                               otherWorker->getMaxShifts());
+        const vector<TimeSlotNode *> &slots = otherWorker->getAvailability();
+        for (size_t j = 0; j < slots.size(); j++) {
+            newWorker->addShift(slots[j]->getDay(), slots[j]->getShift(),
+                                slots[j]->getTruePriority());
+        }
+        workerList.push_back(newWorker);
+        newIds[workerIds[i]] = i;
+    }
+
+    for (size_t i = 0; i < workerIds.size(); i++) {
+        const unordered_set<WorkerNode *> &likes = 
+            other.workerList[workerIds[i]]->getLikedCoworkers();
+        for (auto it = likes.begin(); it != likes.end(); it++) {
+            if (newIds[(*it)->getId()] != -1) {
+                workerList[i]->addLikedCoworker(workerList[newIds[(*it)->getId()]]);
+            }
+        }
+    }
+
+    buildWorkersAvailable();
+    assignIds();
+    findSymmetryClasses();  // likes outside a subset are gone
+
+    presolved = false;
+    if (other.presolved) {
+        presolve();
+    }
+}
+
 WorkerInputData::~WorkerInputData() {
     for (size_t i = 0; i < workerList.size(); i++) {
         delete workerList[i]; // TODO: set these pointer values to NULL after free (same for other pointers as well)
@@ -51,79 +120,322 @@ void WorkerInputData::buildWorkersAvailable() {
     }
 }
 
+// groups of workers connected through shifts they are both available for,
+// each as worker ids in increasing order, ordered by their first worker.
+// Workers in different groups never share a shift, so no path in
+// graphBalance and no coworker bonus crosses between groups
+vector<vector<int>> WorkerInputData::findComponents() {
+    int n = workerList.size();
+    vector<int> parent(n);
+    for (int i = 0; i < n; i++) {
+        parent[i] = i;
+    }
+    // union-find, by the smaller root and with path halving
+    auto find = [&parent](int worker) {
+        while (parent[worker] != worker) {
+            parent[worker] = parent[parent[worker]];
+            worker = parent[worker];
+        }
+        return worker;
+    };
 
-// normalizes priorities based on (X - min) / (max - min) = newPriority
-void WorkerInputData::normalizePriority() {
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            const vector<TimeSlotNode *> &available = workersAvailable[i][j];
+            for (size_t k = 1; k < available.size(); k++) {
+                int first = find(available[0]->getParent()->getId());
+                int curr = find(available[k]->getParent()->getId());
+                parent[max(first, curr)] = min(first, curr);
+            }
+        }
+    }
+
+    vector<vector<int>> components;
+    vector<int> componentOf(n, -1);
+    for (int i = 0; i < n; i++) {
+        int root = find(i);
+        if (componentOf[root] == -1) {
+            componentOf[root] = components.size();
+            components.push_back(vector<int>());
+        }
+        components[componentOf[root]].push_back(i);
+    }
+    return components;
+}
+
+// Two workers are interchangeable if they have the same max shifts, the same
+// shifts at the same priorities, like the same coworkers and are liked by the
+// same coworkers. Swapping them then maps every schedule to one with the same
+// priorities, penalties and bonuses for everyone. Classes are numbered by
+// their first worker, and a worker who likes themselves is in a class alone
+void WorkerInputData::findSymmetryClasses() {
     int n = workerList.size();
+    vector<vector<int>> likedBy(n);
+    for (int i = 0; i < n; i++) {
+        const unordered_set<WorkerNode *> &likes = workerList[i]->getLikedCoworkers();
+        for (auto it = likes.begin(); it != likes.end(); it++) {
+            likedBy[(*it)->getId()].push_back(i);
+        }
+    }
 
-    pair<double, double> minAndMax = findMinMaxPriority();
-    double minPriority = minAndMax.first;
-    double maxPriority = minAndMax.second;
+    vector<vector<Fixed>> signatures(n);
+    vector<int> order(n);
+    for (int i = 0; i < n; i++) {
+        signatures[i] = symmetrySignature(i, likedBy);
+        order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(), [&signatures](int w1, int w2) {
+        return signatures[w1] < signatures[w2];
+    });
+
+    // equal signatures are next to each other, lowest worker id first
+    auto likesSelf = [this](int worker) {
+        return workerList[worker]->getLikedCoworkers().count(workerList[worker]) > 0;
+    };
+    vector<int> firstOfClass(n);
+    for (int i = 0; i < n; i++) {
+        if (i > 0 and !likesSelf(order[i]) and !likesSelf(order[i - 1]) and
+            signatures[order[i]] == signatures[order[i - 1]]) {
+            firstOfClass[order[i]] = firstOfClass[order[i - 1]];
+        } else {
+            firstOfClass[order[i]] = order[i];
+        }
+    }
 
-    // normalize all priorities
+    symmetryClass.assign(n, -1);
+    classSizes.clear();
     for (int i = 0; i < n; i++) {
-        const vector<TimeSlotNode *> timeslots = workerList[i]->getAvailability();
-        for (auto slot = timeslots.begin(); slot != timeslots.end(); slot++) {
-            double newPriority = (*slot)->getTruePriority() - minPriority;
-            if (maxPriority - minPriority != 0) {  // prevent div 0 errors
-                newPriority /= (maxPriority - minPriority);
-            } else {  // all values same, normalize to 1
-                newPriority = 1;
-            }
+        if (firstOfClass[i] == i) {
+            symmetryClass[i] = classSizes.size();
+            classSizes.push_back(0);
+        } else {
+            symmetryClass[i] = symmetryClass[firstOfClass[i]];
+        }
+        classSizes[symmetryClass[i]]++;
+    }
+}
 
+// max shifts, then the sorted (day, shift, priority) of every slot, then the
+// sorted ids of who the worker likes and of who likes them
+vector<Fixed> WorkerInputData::symmetrySignature(int workerId,
+                                                 const vector<vector<int>> &likedBy) {
+    WorkerNode *worker = workerList[workerId];
+    vector<Fixed> signature = {worker->getMaxShifts()};
+
+    vector<tuple<int, int, Fixed>> slots;
+    const vector<TimeSlotNode *> &available = worker->getAvailability();
+    for (size_t i = 0; i < available.size(); i++) {
+        slots.emplace_back(available[i]->getDay(), available[i]->getShift(),
+                           available[i]->getTruePriority());
+    }
+    sort(slots.begin(), slots.end());
+    signature.push_back(slots.size());
+    for (size_t i = 0; i < slots.size(); i++) {
+        signature.push_back(get<0>(slots[i]));
+        signature.push_back(get<1>(slots[i]));
+        signature.push_back(get<2>(slots[i]));
+    }
 
-            (*slot)->setTruePriority(newPriority);
+    vector<int> likes;
+    const unordered_set<WorkerNode *> &liked = worker->getLikedCoworkers();
+    for (auto it = liked.begin(); it != liked.end(); it++) {
+        likes.push_back((*it)->getId());
+    }
+    sort(likes.begin(), likes.end());
+    signature.push_back(likes.size());
+    signature.insert(signature.end(), likes.begin(), likes.end());
+
+    vector<int> likers = likedBy[workerId];
+    sort(likers.begin(), likers.end());
+    signature.push_back(likers.size());
+    signature.insert(signature.end(), likers.begin(), likers.end());
+    return signature;
+}
+
+int WorkerInputData::getSymmetryClass(int workerId) {
+    return symmetryClass[workerId];
+}
+
+int WorkerInputData::getClassSize(int classId) {
+    return classSizes[classId];
+}
+
+// prints nothing if every worker is in a class alone
+void WorkerInputData::printSymmetry(ostream &output) {
+    int classes = 0, members = 0;
+    for (size_t i = 0; i < classSizes.size(); i++) {
+        if (classSizes[i] > 1) {
+            classes++;
+            members += classSizes[i];
+        }
+    }
+    if (classes == 0) {
+        return;
+    }
+    output << "Symmetry: " << members << " of " << workerList.size() 
+           << " workers in " << classes << " classes of interchangeable workers"
+           << endl;
+}
+
+// gives every worker its index as id, and every timeslot a dense id, grouped
+// by worker in worker list order
+void WorkerInputData::assignIds() {
+    slotList.clear();
+    for (size_t i = 0; i < workerList.size(); i++) {
+        workerList[i]->setId(i);
+        workerList[i]->setWeights(&weights);
+        const vector<TimeSlotNode *> &slots = workerList[i]->getAvailability();
+        for (size_t j = 0; j < slots.size(); j++) {
+            slots[j]->setId(slotList.size());
+            slotList.push_back(slots[j]);
         }
     }
 }
 
+// normalizes priorities based on (X - min) / (max - min) = newPriority.
+// Ids are assigned by now, so the priorities are copied into one array by
+// slot id and the kernels work on that
+void WorkerInputData::normalizePriority() {
+    vector<Fixed> priorities(slotList.size());
+    for (size_t i = 0; i < slotList.size(); i++) {
+        priorities[i] = slotList[i]->getTruePriority();
+    }
+
+    pair<Fixed, Fixed> minAndMax = findMinMaxPriority(priorities);
+    Fixed minPriority = minAndMax.first;
+    Fixed maxPriority = minAndMax.second;
+    if (maxPriority - minPriority != 0) {  // prevent div 0 errors
+        PriorityKernels::normalize(priorities.data(), priorities.size(),
+                                   minPriority, maxPriority);
+    } else {  // all values same, normalize to 1
+        fill(priorities.begin(), priorities.end(), FIXED_ONE);
+    }
+
+    for (size_t i = 0; i < slotList.size(); i++) {
+        slotList[i]->setTruePriority(priorities[i]);
+    }
+}
+
 // first is minimum priority of any worker, second is maximum
-pair<double, double> WorkerInputData::findMinMaxPriority() {
-    int n = workerList.size();
-    if (n == 0) {
-        return {0, 0};
+pair<Fixed, Fixed> WorkerInputData::findMinMaxPriority(const vector<Fixed> &priorities) {
+    return PriorityKernels::findMinMax(priorities.data(), priorities.size());
+}
+
+
+/********************************** Presolve **********************************/
+
+// finds the assignments every schedule has to make: a shift with exactly as
+// many workers available as it requires uses all of them. Those slots are
+// marked forced and graphBalance neither starts a path at one nor drops one,
+// since nobody could take the shift over. Every construction fills a forced
+// shift with all its workers anyway; allocating them before it only changed
+// the order of the other choices, and found worse schedules.
+// The only hard constraints are the number of workers per shift and one slot
+// per worker per shift. maxShifts is a target that balancing trades off
+// against priorities, so a worker with exactly maxShifts slots is counted
+// but not forced, and forcing a shift makes no other assignment forced. One
+// pass reaches the fixpoint
+void WorkerInputData::presolve() {
+    presolved = true;
+    for (size_t i = 0; i < forcedSlots.size(); i++) {
+        forcedSlots[i]->setForced(false);  // from an earlier presolve
     }
-    
-    // get min and max priorities
-    double minPriority;
-    double maxPriority;
-    bool firstTime = true;
-    for (int i = 0; i < n; i++) {
-        vector<TimeSlotNode *> timeslots = workerList[i]->getAvailability();
-        for (auto slot = timeslots.begin(); slot != timeslots.end(); slot++) {
-            if (firstTime or (*slot)->getTruePriority() < minPriority) {
-                minPriority = (*slot)->getTruePriority();
-            }
-            if (firstTime or (*slot)->getTruePriority() > maxPriority) {
-                maxPriority = (*slot)->getTruePriority();
+    forcedSlots.clear();
+    forcedShifts = 0;
+    idleSlots = 0;
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            const vector<TimeSlotNode *> &available = workersAvailable[i][j];
+            if (workersPerShift[i][j] == 0) {
+                idleSlots += available.size();
+            } else if ((int) available.size() == workersPerShift[i][j]) {
+                forcedShifts++;
+                for (size_t k = 0; k < available.size(); k++) {
+                    available[k]->setForced(true);
+                    forcedSlots.push_back(available[k]);
+                }
             }
+        }
+    }
 
-            firstTime = false;
+    fixedWorkers = 0;
+    tightWorkers = 0;
+    for (size_t i = 0; i < workerList.size(); i++) {
+        const vector<TimeSlotNode *> &available = workerList[i]->getAvailability();
+        bool allForced = !available.empty();
+        for (size_t j = 0; j < available.size(); j++) {
+            allForced = allForced and available[j]->getForced();
+        }
+        if (allForced) {
+            fixedWorkers++;
+        }
+        if ((int) available.size() == workerList[i]->getMaxShifts()) {
+            tightWorkers++;
         }
     }
-    return {minPriority, maxPriority};
 }
 
+void WorkerInputData::printPresolve(ostream &output) {
+    int numShifts = 0;
+    for (int i = 0; i < NUM_DAYS; i++) {
+        for (int j = 0; j < MAX_SHIFTS; j++) {
+            numShifts += workersPerShift[i][j] > 0;
+        }
+    }
+
+    int searchable = slotList.size() - idleSlots - forcedSlots.size();
+    output << "Presolve: " << forcedShifts << " of " << numShifts 
+           << " shifts forced, " << forcedSlots.size() << " of " 
+           << slotList.size() << " slots forced, " << fixedWorkers << " of " 
+           << workerList.size() << " workers fixed" << endl;
+    output << "    slots left to search: " << searchable << " (" 
+           << idleSlots << " more are in shifts that need nobody)" << endl;
+    output << "    workers with exactly max shifts available: " << tightWorkers
+           << " (not forced, max shifts is a target)" << endl;
+}
 
 
 /******************************** File Reading ********************************/
 
+// a directory of worker files, a bulk file, or "-" for a bulk file on
+// standard input
+void WorkerInputData::readInput(string &inputPath) {
+    vector<vector<string>> likes;
+    if (inputPath == "-") {
+        readBulk(cin, "standard input", likes);
+    } else if (filesystem::is_directory(inputPath)) {
+        readFiles(inputPath, likes);
+    } else {
+        ifstream infile;
+        openOrRuntimeError(infile, inputPath);
+        readBulk(infile, inputPath, likes);
+    }
+
+    processLikes(likes); // add all the likes to worker nodes
+}
+
 // TODO: is there a way to do this without using the directory iterator?
-void WorkerInputData::readFiles(string &inputDirectory) {
+void WorkerInputData::readFiles(string &inputDirectory, 
+                                vector<vector<string>> &likes) {
     if (inputDirectory[inputDirectory.size() - 1] != '/') {
         inputDirectory += '/';  // make sure always ends in a slash
     }
 
-    vector<vector<string>> likes;
+    // directory order is unspecified, so sort to keep the worker order (and
+    // with it every seed's result) the same on every machine
+    vector<string> filenames;
     for (const auto &entry : filesystem::directory_iterator(inputDirectory)) {
-        string filename = entry.path();
+        filenames.push_back(entry.path());
+    }
+    sort(filenames.begin(), filenames.end());
 
+    for (const string &filename : filenames) {
         ifstream infile;
         openOrRuntimeError(infile, filename);
 
         string name;
         int maxShifts;
-        readHeader(infile, name, maxShifts);
+        readHeader(infile, filename, name, maxShifts);
         WorkerNode *newWorker = new WorkerNode(name, maxShifts);
 
 
@@ -133,65 +445,156 @@ void WorkerInputData::readFiles(string &inputDirectory) {
         workerList.push_back(newWorker);
         infile.close();
     }
-
-    processLikes(likes); // add all the likes to worker nodes
 }
 
-void WorkerInputData::readHeader(ifstream &infile, string &name, int &maxShifts) {
-        getline(infile, name);
-        infile >> maxShifts;
-
-        // TODO: this is a bit of a hack
-        char c;
-        infile.get(c); // grab the trailing newlines
-        infile.get(c);
+// the name and max shifts, each on their own line, then a blank line
+void WorkerInputData::readHeader(istream &infile, const string &filename,
+                                 string &name, int &maxShifts) {
+    string maxShiftsLine;
+    string blank;
+    readLine(infile, name);
+    readLine(infile, maxShiftsLine);
+    maxShifts = parseMaxShifts(maxShiftsLine, "file " + filename);
+    if (readLine(infile, blank) and blank != "") {
+        throw runtime_error("Expected a blank line after the max shifts in " 
+                            "file " + filename);
+    }
 }
 
-void WorkerInputData::readShifts(ifstream &infile, string filename, WorkerNode *currWorker) {
+void WorkerInputData::readShifts(istream &infile, string filename, WorkerNode *currWorker) {
     string lineContents;
+    while (readLine(infile, lineContents) && lineContents != "") {
+        istringstream line(lineContents);
+        readShift(line, filename, currWorker);
+    }
+}
 
+// "dayName shiftName priority", any whitespace between them. Skips the shift
+// with a message if it is invalid
+void WorkerInputData::readShift(istream &line, const string &filename, 
+                                WorkerNode *currWorker) {
     string dayName;
     string shiftName;
     double priority;
-
-    int day;
-    int shift;
-    while (getline(infile, lineContents) && lineContents != "") {
-        istringstream line(lineContents);
-        line >> dayName >> shiftName >> priority;
-
-        day = dayStringToInt(dayName);
-        shift = shiftStringToInt(shiftName);
-        if (day == -1) {
-            cerr << "Invalid Day Name: " << dayName << " in file "
-                 << filename << endl;
-        } else if (shift == -1) {
-            cerr << "Invalid Shift Name: " << shiftName << " in file "
-                 << filename << endl;
-        } else if (line.fail()) { // most likely couldn't read double
-            cerr << "File reading fail in " << filename 
-                 << ". Most likely couldn't read priority" << endl;
-        } else { // no problems, so add the shift
-            currWorker->addShift(day, shift, priority);
-        }
+    line >> dayName >> shiftName >> priority;
+
+    int day = dayStringToInt(dayName);
+    int shift = shiftStringToInt(shiftName);
+    if (day == -1) {
+        cerr << "Invalid Day Name: " << dayName << " in file "
+             << filename << endl;
+    } else if (shift == -1) {
+        cerr << "Invalid Shift Name: " << shiftName << " in file "
+             << filename << endl;
+    } else if (line.fail()) { // most likely couldn't read double
+        cerr << "File reading fail in " << filename 
+             << ". Most likely couldn't read priority" << endl;
+    } else if (!(abs(priority) < FIXED_LIMIT)) {
+        cerr << "Priority " << priority << " in file " << filename
+             << " is too large, must be below " << FIXED_LIMIT << endl;
+    } else { // no problems, so add the shift
+        currWorker->addShift(day, shift, toFixed(priority));
     }
 }
 
-vector<string> WorkerInputData::readLikes(ifstream &infile) {
+vector<string> WorkerInputData::readLikes(istream &infile) {
     vector<string> currLikes;
     string name;
-    while (getline(infile, name)) {
+    while (readLine(infile, name)) {
         currLikes.push_back(name);
     }
     return currLikes;
 }
 
+// Every worker in one tab separated stream, read line by line, so that a
+// roster of thousands of workers is one sequential read instead of a file
+// each. Rows belong to the worker row above them:
+//     worker <TAB> name <TAB> max shifts
+//     shift <TAB> dayName <TAB> shiftName <TAB> priority
+//     like <TAB> name
+// Blank lines and lines starting with '#' are skipped. Workers are in the
+// order of the stream
+void WorkerInputData::readBulk(istream &input, const string &source,
+                               vector<vector<string>> &likes) {
+    string lineContents;
+    int lineNumber = 0;
+    while (readLine(input, lineContents)) {
+        lineNumber++;
+        if (lineContents == "" or lineContents[0] == '#') {
+            continue;
+        }
+        string where = source + " line " + to_string(lineNumber);
+        istringstream line(lineContents);
+        string kind;
+        getline(line, kind, '\t');
+
+        if (kind == "worker") {
+            string name;
+            string maxShifts;
+            getline(line, name, '\t');
+            getline(line, maxShifts);
+            if (name == "") {
+                throw runtime_error("Missing worker name in " + where);
+            }
+            workerList.push_back(new WorkerNode(name, 
+                                                parseMaxShifts(maxShifts, where)));
+            likes.emplace_back();
+        } else if (workerList.empty() and (kind == "shift" or kind == "like")) {
+            throw runtime_error("A " + kind + " row before any worker row in " 
+                                + where);
+        } else if (kind == "shift") {
+            readShift(line, where, workerList.back());
+        } else if (kind == "like") {
+            string name;
+            getline(line, name);
+            likes.back().push_back(name);
+        } else {
+            throw runtime_error("Unknown row \"" + kind + "\" in " + where);
+        }
+    }
+    if (input.bad()) {
+        throw runtime_error("Unable to read " + source);
+    }
+}
+
+// throws a runtime_error if the line is not a whole non-negative number
+int WorkerInputData::parseMaxShifts(string value, const string &where) {
+    value.erase(value.find_last_not_of(" \t") + 1);
+    size_t used = 0;
+    int maxShifts = -1;
+    try {
+        maxShifts = stoi(value, &used);
+    } catch (const logic_error &) {
+        used = 0;
+    }
+    if (used == 0 or used != value.size() or maxShifts < 0) {
+        throw runtime_error("Invalid max shifts \"" + value + "\" in " + where);
+    }
+    return maxShifts;
+}
+
+// getline without the carriage return of a file written on Windows
+bool WorkerInputData::readLine(istream &input, string &line) {
+    if (!getline(input, line)) {
+        return false;
+    }
+    if (!line.empty() and line.back() == '\r') {
+        line.pop_back();
+    }
+    return true;
+}
+
+// by name, since there can be thousands of workers
 void WorkerInputData::processLikes(vector<vector<string>> &likes) {
+    unordered_map<string, WorkerNode *> byName;
+    for (size_t i = 0; i < workerList.size(); i++) {
+        byName.emplace(workerList[i]->getName(), workerList[i]);
+    }
     for (size_t i = 0; i < likes.size(); i++) {
         for (string name : likes[i]) {
-            WorkerNode *liked = findWorker(name);
-            if (liked != nullptr) {
-                workerList[i]->addLikedCoworker(liked);
+            auto liked = byName.find(name);
+            if (liked != byName.end()) {
+                workerList[i]->addLikedCoworker(liked->second);
             } else {
                 cerr << name << ", liked by " << workerList[i]->getName() 
                      << ", is was not found" << endl;
@@ -200,17 +603,6 @@ void WorkerInputData::processLikes(vector<vector<string>> &likes) {
     }
 }
 
-WorkerNode *WorkerInputData::findWorker(string name) {
-    for (size_t i = 0; i < workerList.size(); i++) {
-        if (workerList[i]->getName() == name) {
-            return workerList[i];
-        }
-    }
-    return nullptr;
-}
-
-
-
 int WorkerInputData::dayStringToInt(string dayName) {
     for (int i = 0; i < NUM_DAYS; i++) {
         if (dayName == dayNames[i]) {
@@ -334,10 +726,39 @@ int WorkerInputData::getWorkersPerShift(int day, int shift) {
     return workersPerShift[day][shift];
 }
 
+// unlike the numbers in ScheduleData.h, which are lowered when the input is
+// read, throws a runtime_error if too few workers are available. Presolves
+// again if the input was presolved
+void WorkerInputData::setWorkersPerShift(int day, int shift, int needed) {
+    int numWorkers = workersAvailable[day][shift].size();
+    if (needed < 0 or needed > numWorkers) {
+        throw runtime_error("Error: " + dayNames[day] + " " + shiftNames[shift]
+                            + " cannot need " + to_string(needed) + " workers, "
+                            + to_string(numWorkers) + " are available");
+    }
+    workersPerShift[day][shift] = needed;
+    if (presolved) {
+        presolve();
+    }
+}
+
+const ScoreWeights &WorkerInputData::getWeights() {
+    return weights;
+}
+
+// throws a runtime_error if the value is out of range
+void WorkerInputData::setWeight(Weight weight, double value) {
+    weights.set(weight, value);
+}
+
 vector<WorkerNode *> &WorkerInputData::getWorkerList() {
     return workerList;
 }
 
+const vector<TimeSlotNode *> &WorkerInputData::getSlotList() {
+    return slotList;
+}
+
 WorkerNode *WorkerInputData::getWorker(int listIndex) {
     return workerList[listIndex];
 }
@@ -2,6 +2,8 @@
 
 WorkerNode::WorkerNode(string newName, int newMaxShifts) {
     name = newName;
+    id = -1;
+    weights = nullptr;
     maxShifts = newMaxShifts;
 
     resetRunValues();
@@ -16,7 +18,10 @@ WorkerNode::~WorkerNode() {
 void WorkerNode::resetRunValues() {
     restoreInitialValues();
 
+    // a worker can never hold more blocks than they are available for, so
+    // this is the only capacity timesAllocated will ever need
     timesAllocated.clear();
+    timesAllocated.reserve(timesAvailable.size());
     // reset the values of the time slot nodes;
     for (auto it = timesAvailable.begin(); it != timesAvailable.end(); it++) {
         (*it)->resetRunValues();
@@ -53,6 +58,22 @@ const string WorkerNode::getName() const {
     return name;
 }
 
+int WorkerNode::getId() const {
+    return id;
+}
+
+void WorkerNode::setId(int newId) {
+    id = newId;
+}
+
+const ScoreWeights &WorkerNode::getWeights() const {
+    return *weights;
+}
+
+void WorkerNode::setWeights(const ScoreWeights *newWeights) {
+    weights = newWeights;
+}
+
 int WorkerNode::getShiftsRemaining() const {
     return shiftsRemaining;
 }
@@ -71,7 +92,7 @@ void WorkerNode::updateShiftsRemaining(int updateFactor) {
 }
 
 
-void WorkerNode::addShift(int day, int shift, double priority) {
+void WorkerNode::addShift(int day, int shift, Fixed priority) {
     TimeSlotNode *newShift = new TimeSlotNode(this, day, shift, priority);
 
     timesAvailable.push_back(newShift);
@@ -4,46 +4,84 @@
  *  
  *  Driver file for scheduling Workers into TimeSlots
  * 
- *  usage: "./oh_scheduler [inputFileDirectory]"
+ *  usage: "./oh_scheduler [inputFileDirectory|bulkFile|-]"
+ *         "./oh_scheduler merge [resultFile...]"
  */
 
 // TODO: transition to 8 space indentation
 
 #include <signal.h>  // catch SIGINT
 
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <string>
-#include <limits.h>
-
-#include <chrono>
 
+#include "ComponentSweep.h"
+#include "ExactSolver.h"
+#include "RunOptions.h"
+#include "ScenarioSweep.h"
 #include "Scheduler.h"
 #include "ScheduleData.h"
+#include "SeedSweep.h"
+#include "ShardResult.h"
+#include "ThreadPool.h"
 
 using namespace std;
 
 void siginthandler(int param);
-void printResult(WorkerInputData &general, unsigned int seed);
-void singleSeed(char inputDirectory[], string seedParameter);
+void printResult(WorkerInputData &general, unsigned int seed,
+                 const Perturbation &perturbation, const RunOptions &options,
+                 unsigned int seedsChecked, ThreadPool *pool);
+void printRelinked(WorkerInputData &general, const EliteSchedule &relinked,
+                   const RunOptions &options, unsigned int seedsChecked,
+                   ThreadPool *pool);
+void printScheduler(Scheduler &scheduler, const RunOptions &options,
+                    unsigned int firstSeed, unsigned int seedsChecked);
+void sweepComponents(WorkerInputData &general, const RunOptions &options,
+                     ThreadPool *pool);
+void solveExact(WorkerInputData &general, const RunOptions &options,
+                ThreadPool *pool);
+void sweepScenarios(WorkerInputData &general, const RunOptions &options,
+                    ThreadPool *pool);
+void mergeResults(const RunOptions &options);
 
 
 // 'pass' something into the siginthandler function. From what I can tell, no
 // other way besides a global variable
-bool keepGoing;
+atomic<bool> keepGoing;
 
 int main(int argc, char *argv[]) {
-    if (argc != 2 and argc != 3) {  // Check for proper amount of arguments
-        cerr << "usage: ./oh_scheduler [inputFileDirectory] "
-                "(optional)[--seed=]"
-             << endl;
+    RunOptions options;
+    try {
+        options = parseRunOptions(argc, argv);
+    } catch (const runtime_error &e) {
+        cerr << e.what() << endl;
+        printUsage(cerr);
         exit(EXIT_FAILURE);
     }
 
-    string directory = argv[1];
+    if (options.merge) {
+        mergeResults(options);
+        return 0;
+    }
+
+    WorkerInputData general(options.inputPath);
+    general.printSymmetry(cerr);
+    if (options.presolve) {
+        general.presolve();
+        general.printPresolve(cerr);
+    }
+
+    unique_ptr<ThreadPool> searchPool;
+    if (options.searchThreads > 1) {
+        searchPool.reset(new ThreadPool(options.searchThreads));
+    }
 
-    if (argc == 3) {
-        string seedParam = argv[2];
-        singleSeed(argv[1], seedParam);
+    if (options.singleSeed) {
+        printResult(general, options.seed, 
+                    SeedSweep::perturbationFor(options, options.seed), options, 
+                    1, searchPool.get());
         return 0;
     }
 
@@ -51,54 +89,35 @@ int main(int argc, char *argv[]) {
          << endl;
     signal(SIGINT, siginthandler);
 
-    double greatest = -1.0;
-    unsigned int indexGreatest = 1;
-
-    WorkerInputData general(directory);
-
-    auto t1 = chrono::high_resolution_clock::now();
-
-    unsigned int i = 1;
-    bool firstTime = true;
     keepGoing = true;
-    while(keepGoing and i != UINT_MAX) {
-        Scheduler scheduler(general, i);
-        scheduler.calculate(); // create the schedule
-        double average = scheduler.getAverage();
-        double lowest = scheduler.getLeastHappy();
-        int range = scheduler.getRange();
-        double result = (averageProportion * average) 
-                        + (lowestProportion * lowest) 
-                        + (overbookedRange * range);
-
-        if (firstTime or result > greatest) {
-            greatest = result;
-            indexGreatest = i;
-            cerr << "Best Result: Average = " << average << ", lowest = " << lowest 
-                 << ", range = " << range << ", seed = " << i << endl;
-            firstTime = false;
-        }
-
-        if (i % 1000 == 0) { // useful for determining speed
-            cerr << "At Seed: " << i << endl;
-        }
-
-        i++;
-        general.resetValues();
-        // break;
+    if (options.components) {
+        sweepComponents(general, options, searchPool.get());
+        return 0;
+    }
+    if (options.exact) {
+        solveExact(general, options, searchPool.get());
+        return 0;
+    }
+    if (options.scenarioFile != "") {
+        sweepScenarios(general, options, searchPool.get());
+        return 0;
     }
-    auto t2 = chrono::high_resolution_clock::now();
 
+    SeedSweep sweep(general, options, searchPool.get());
+    sweep.run(keepGoing);
 
-    cerr << "Final Checked Seed: " << i - 1 << endl;
-    printResult(general, indexGreatest);
+    cerr << "Final Checked Seed: " 
+         << options.firstSeed + sweep.getSeedsChecked() - 1 << endl;
+    if (sweep.getRelinkedBest() != nullptr) {
+        printRelinked(general, *sweep.getRelinkedBest(), options, 
+                      sweep.getSeedsChecked(), searchPool.get());
+    } else {
+        printResult(general, sweep.getBestSeed(), sweep.getBestPerturbation(),
+                    options, sweep.getSeedsChecked(), searchPool.get());
+    }
     cout << endl;
 
-    auto ms_int = chrono::duration_cast<chrono::milliseconds>(t2 - t1); // TODO: add chrono as command line, not just something that always happens
-    double timeTaken = (double) ms_int.count() / 1000;
-    cout << "Time taken (s): " << timeTaken << endl;
-    cout << "Iterations per second: " << (double) (i - 1) / timeTaken << endl;
-
+    sweep.printProfile(cout);
 
     return 0;
 }
@@ -109,19 +128,134 @@ void siginthandler(int param) {
     cout << '\n' << endl;
 }
 
-void printResult(WorkerInputData &general, unsigned int seed) {
+void printResult(WorkerInputData &general, unsigned int seed,
+                 const Perturbation &perturbation, const RunOptions &options,
+                 unsigned int seedsChecked, ThreadPool *pool) {
     Scheduler scheduler(general, seed);
+    SeedSweep::configureScheduler(scheduler, options, pool);
+    scheduler.setPerturbation(perturbation);
     scheduler.calculate();
+
+    unsigned int firstSeed = options.singleSeed ? seed : options.firstSeed;
+    printScheduler(scheduler, options, firstSeed, seedsChecked);
+}
+
+// a schedule found by path relinking is no seed's, so it is loaded instead
+// of calculated. Its stats name the seed it started from
+void printRelinked(WorkerInputData &general, const EliteSchedule &relinked,
+                   const RunOptions &options, unsigned int seedsChecked,
+                   ThreadPool *pool) {
+    Scheduler scheduler(general, relinked.seed);
+    SeedSweep::configureScheduler(scheduler, options, pool);
+    scheduler.setPerturbation(relinked.perturbation);
+
+    const vector<TimeSlotNode *> &slotList = general.getSlotList();
+    vector<TimeSlotNode *> slots;
+    for (size_t i = 0; i < relinked.slotIds.size(); i++) {
+        slots.push_back(slotList[relinked.slotIds[i]]);
+    }
+    scheduler.loadSchedule(slots);
+
+    printScheduler(scheduler, options, options.firstSeed, seedsChecked);
+}
+
+// refines the schedule first with --lns
+void printScheduler(Scheduler &scheduler, const RunOptions &options,
+                    unsigned int firstSeed, unsigned int seedsChecked) {
+    if (options.refine > 0) {
+        scheduler.refine(options.refine);
+    }
+
     scheduler.printWorkerShiftNum(cout);
     scheduler.printFinalSchedule(cout);
     scheduler.printStats(cout);
+    if (options.refine > 0) {
+        scheduler.printRefineStats(cout);
+    }
+
+    if (options.resultOut != "") {
+        unsigned int lastSeed = firstSeed + seedsChecked - 1;
+        ShardResult result(scheduler, firstSeed, lastSeed, seedsChecked);
+        result.write(options.resultOut);
+    }
 }
 
-// TODO: this is a tad dangerous. It doesn't check that it is actually --seed=, 
-//       only that it is the first parameter
-void singleSeed(char inputDirectory[], string seedParameter) { // --seed=
-    unsigned int seed = stoi(seedParameter.substr(7, 
-                             seedParameter.length() - 7));
-    WorkerInputData general(inputDirectory);
-    printResult(general, seed);
+// sweeps every component of the input on its own and prints them put
+// together. The result file's seed is the first of the range, the seed of
+// each component is printed with the components
+void sweepComponents(WorkerInputData &general, const RunOptions &options,
+                     ThreadPool *pool) {
+    ComponentSweep sweep(general, options, pool);
+    sweep.run(keepGoing);
+
+    cerr << "Final Checked Seed: " 
+         << options.firstSeed + sweep.getSeedsChecked() - 1 << endl;
+    Scheduler scheduler(general, options.firstSeed);
+    SeedSweep::configureScheduler(scheduler, options, pool);
+    sweep.combine(scheduler);
+    printScheduler(scheduler, options, options.firstSeed, 
+                   sweep.getSeedsChecked());
+    cout << endl;
+
+    sweep.printComponents(cout);
+    sweep.printProfile(cout);
+}
+
+// branch and bound from the best of the first seeds of the range. The result
+// file's seed is the first of the range; the schedule may be no seed's
+void solveExact(WorkerInputData &general, const RunOptions &options,
+                ThreadPool *pool) {
+    ExactSolver solver(general, options.threads);
+    Scheduler scheduler(general, options.firstSeed);
+    SeedSweep::configureScheduler(scheduler, options, pool);
+    unsigned int seedsChecked = 0;
+    for (unsigned int seed = options.firstSeed; 
+         keepGoing and seedsChecked < ExactSolver::WARM_START_SEEDS; seed++) {
+        if (seed != options.firstSeed) {
+            scheduler.reset(seed);
+        }
+        scheduler.setPerturbation(SeedSweep::perturbationFor(options, seed));
+        scheduler.calculate();
+        solver.offerIncumbent(scheduler);
+        seedsChecked++;
+        if (seed == options.lastSeed) {
+            break;
+        }
+    }
+
+    solver.run(keepGoing);
+    // under the first seed, which printScheduler names
+    scheduler.reset(options.firstSeed);
+    scheduler.setPerturbation(SeedSweep::perturbationFor(options, 
+                                                         options.firstSeed));
+    solver.load(scheduler);
+    printScheduler(scheduler, options, options.firstSeed, seedsChecked);
+    cout << endl;
+
+    solver.printStats(cout);
+}
+
+// sweeps the baseline and every scenario of the file, and prints how their
+// best schedules compare instead of any one schedule
+void sweepScenarios(WorkerInputData &general, const RunOptions &options,
+                    ThreadPool *pool) {
+    ScenarioSweep sweep(general, options, pool);
+    sweep.run(keepGoing);
+
+    sweep.printScenarios(cout);
+    cout << endl;
+    sweep.printTable(cout);
+    cout << endl;
+    sweep.printProfile(cout);
+}
+
+// picks the global best out of the result files of several sweeps
+void mergeResults(const RunOptions &options) {
+    ShardResult best = ShardResult::merge(options.mergeFiles);
+    best.printSummary(cout);
+    best.printAssignment(cout);
+
+    if (options.resultOut != "") {
+        best.write(options.resultOut);
+    }
 }